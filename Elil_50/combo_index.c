@@ -0,0 +1,219 @@
+/*
+This is the c file of the combo index
+
+QMK walks every combo in key_combos[] on each key press and release.
+Here combo_count() and combo_get() are overridden to expose only the combos the held keys can take part in:
+- at boot, each matrix position gets the set of combos using any keycode it holds on any layer;
+- on each scan, the newly pressed positions append their combos to the current view;
+- the view is emptied once the whole matrix has been released for a full scan.
+The view is append-only while keys are held, so the combo indices QMK buffers never change meaning.
+
+Eager combos: QMK keeps a completed combo buffered until the combo term expires, in case a longer combo follows.
+Combos that are no subset of a longer combo (prefix-free, found at boot) cannot grow, so once QMK's state of one
+has all of its keys down, and it is neither active nor disabled, it waits in the buffer for nothing.
+process_combo() applies the buffered combos on any event but a combo key press, so it is handed a release of KC_NO:
+KC_NO is COMBO_END, which matches no key of any combo, and the record goes nowhere else.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "combo_index.h"
+
+#ifndef COMBO_INDEX_MAX
+#    define COMBO_INDEX_MAX 192 // key_combos[] holds 183 entries
+#endif
+
+#define COMBO_INDEX_BYTES ((COMBO_INDEX_MAX + 7) / 8)
+
+#define COMBO_KEYS_MAX 3 // longest combo in key_combos[]
+
+#define BIT_GET(set, i) ((set)[(i) / 8] & (1 << ((i) % 8)))
+#define BIT_SET(set, i) ((set)[(i) / 8] |= (1 << ((i) % 8)))
+
+static uint8_t pos_combos[MATRIX_ROWS][MATRIX_COLS][COMBO_INDEX_BYTES]; // combos each position can trigger
+static uint8_t view_member[COMBO_INDEX_BYTES];
+static uint8_t view[COMBO_INDEX_MAX]; // raw combo indices, in the order they joined the view
+static uint8_t view_len = 0;
+static bool    index_ready = false;
+
+static uint8_t prefix_free[COMBO_INDEX_BYTES]; // combos no longer combo contains
+static bool    key_pressed = false; // a key went down since the last task
+
+static matrix_row_t previous[MATRIX_ROWS];
+static bool         was_down = false;
+
+static uint32_t index_events = 0; // press and release edges
+static uint32_t index_visits = 0; // combo_get() calls made by the matcher
+static uint32_t index_eager = 0; // combos flushed before their term
+
+
+static bool combo_has_keycode(combo_t *combo, uint16_t keycode) {
+    for (const uint16_t *keys = combo->keys;; keys++) {
+        uint16_t key = pgm_read_word(keys);
+        if (key == COMBO_END) return false;
+        if (key == keycode) return true;
+    }
+}
+
+static uint8_t combo_keys(combo_t *combo, uint16_t keys[COMBO_KEYS_MAX]) {
+    uint8_t count = 0;
+    for (const uint16_t *key = combo->keys; count < COMBO_KEYS_MAX; key++) {
+        uint16_t keycode = pgm_read_word(key);
+        if (keycode == COMBO_END) break;
+        keys[count++] = keycode;
+    }
+    return count;
+}
+
+// true if every key of the shorter combo is also in the longer one
+static bool combo_is_subset(combo_t *shorter, combo_t *longer) {
+    uint16_t keys[COMBO_KEYS_MAX];
+    uint8_t  count = combo_keys(shorter, keys);
+    for (uint8_t i = 0; i < count; i++) {
+        if (!combo_has_keycode(longer, keys[i])) return false;
+    }
+    return true;
+}
+
+static void find_prefix_free_combos(uint16_t count) {
+    for (uint16_t idx = 0; idx < count; idx++) {
+        combo_t *combo = combo_get_raw(idx);
+        uint16_t keys[COMBO_KEYS_MAX];
+        uint8_t  length = combo_keys(combo, keys);
+        bool     free = true;
+
+        for (uint16_t other = 0; other < count && free; other++) {
+            uint16_t other_keys[COMBO_KEYS_MAX];
+            if (other != idx && combo_keys(combo_get_raw(other), other_keys) > length) {
+                free = !combo_is_subset(combo, combo_get_raw(other));
+            }
+        }
+        if (free) BIT_SET(prefix_free, idx);
+    }
+}
+
+void combo_index_init(void) {
+    uint16_t count = combo_count_raw();
+    if (count > COMBO_INDEX_MAX) {
+        dprintf("combo_index: %u combos, raise COMBO_INDEX_MAX\n", count);
+        return; // fall back to the full table
+    }
+
+    uint8_t layers = keymap_layer_count();
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            for (uint8_t layer = 0; layer < layers; layer++) {
+                uint16_t keycode = keycode_at_keymap_location(layer, row, col);
+                if (keycode == KC_NO || keycode == KC_TRNS) continue;
+
+                for (uint16_t idx = 0; idx < count; idx++) {
+                    if (combo_has_keycode(combo_get_raw(idx), keycode)) {
+                        BIT_SET(pos_combos[row][col], idx);
+                    }
+                }
+            }
+        }
+    }
+    find_prefix_free_combos(count);
+    index_ready = true;
+}
+
+// a prefix-free combo of the view is complete in QMK's state and still buffered
+static bool eager_combo_ready(void) {
+    for (uint8_t i = 0; i < view_len; i++) {
+        if (!BIT_GET(prefix_free, view[i])) continue;
+
+        combo_t *combo = combo_get_raw(view[i]);
+        uint16_t keys[COMBO_KEYS_MAX];
+        uint8_t  count = combo_keys(combo, keys);
+        if (combo->state == (1 << count) - 1 && !combo->active && !combo->disabled) return true;
+    }
+    return false;
+}
+
+static void view_add_position(uint8_t row, uint8_t col) {
+    uint16_t count = combo_count_raw();
+    for (uint16_t idx = 0; idx < count; idx++) {
+        if (BIT_GET(pos_combos[row][col], idx) && !BIT_GET(view_member, idx)) {
+            BIT_SET(view_member, idx);
+            view[view_len++] = idx;
+        }
+    }
+}
+
+void combo_index_scan(void) {
+    if (!index_ready) return;
+
+    bool any_down = false;
+    bool key_press = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t current = matrix_get_row(row);
+        matrix_row_t pressed = current & ~previous[row];
+
+        key_press |= pressed != 0;
+        for (uint8_t col = 0; pressed; col++, pressed >>= 1) {
+            if (pressed & 1) view_add_position(row, col);
+        }
+        index_events += __builtin_popcount(current ^ previous[row]);
+        any_down |= current != 0;
+        previous[row] = current;
+    }
+
+    // the releases seen by the previous scan have been processed: nothing can reference the view anymore
+    if (!any_down && !was_down && view_len) {
+        memset(view_member, 0, sizeof(view_member));
+        view_len = 0;
+    }
+    was_down = any_down;
+
+    key_pressed |= key_press;
+}
+
+void combo_index_resync(void) {
+    if (!index_ready) return;
+
+    bool any_down = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        previous[row] = matrix_get_row(row); // the keys pressed meanwhile never reached QMK's combo state
+        any_down |= previous[row] != 0;
+    }
+    was_down = any_down;
+}
+
+void combo_index_task(void) {
+    if (!key_pressed) return;
+
+    key_pressed = false;
+    if (eager_combo_ready()) { // the press completed a chord that cannot grow any further
+        keyrecord_t record = {.event = MAKE_COMBOEVENT(false)};
+        index_eager++;
+        process_combo(KC_NO, &record);
+    }
+}
+
+bool combo_index_active(void) {
+    return view_len != 0;
+}
+
+uint16_t combo_count(void) {
+    return index_ready ? view_len : combo_count_raw();
+}
+
+combo_t *combo_get(uint16_t combo_idx) {
+    index_visits++;
+    return combo_get_raw(index_ready ? view[combo_idx] : combo_idx);
+}
+
+void combo_index_dump(void) {
+    // without the index every press and release walks the whole table
+    uprintf("combo index: events=%lu combos/event before=%u after=%lu.%02lu\n", index_events, combo_count_raw(),
+            index_events ? index_visits / index_events : 0, index_events ? (index_visits * 100 / index_events) % 100 : 0);
+    uprintf("combo index: eager combos=%lu\n", index_eager);
+    index_events = 0;
+    index_visits = 0;
+    index_eager = 0;
+}
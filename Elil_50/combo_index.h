@@ -0,0 +1,19 @@
+/*
+This is the header of the combo index: it narrows the combos QMK scans on each key event
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void combo_index_init(void);   // call once the keymap is readable (keyboard_post_init_user)
+void combo_index_scan(void);   // call from matrix_scan_user, before the events are processed
+void combo_index_task(void);   // call from housekeeping_task_user, after the events are processed
+void combo_index_resync(void); // call when combos come back on after scans that skipped combo_index_scan
+bool combo_index_active(void); // a combo key is held: some combo may still fire
+void combo_index_dump(void);   // console report of the matcher cost
@@ -12,20 +12,24 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #define MASTER_LEFT
 #undef DEBOUNCE
-#define DEBOUNCE 3
+#define DEBOUNCE 3 // ms a release must read open, presses do not wait: see custom_debounce.c
 
 #define TAPPING_TERM 150
+#define TAPPING_TERM_PER_KEY // adaptive, see tapping_term.c
 #define QUICK_TAP_TERM 0
+#define QUICK_TAP_TERM_PER_KEY // but the double tap keys of double_tap.c, else QMK never counts their second tap
 
 #define HOLD_ON_OTHER_KEY_PRESS
+#define HOLD_ON_OTHER_KEY_PRESS_PER_KEY // off in fast bursts for the keys of tapping_term.c
 #define PERMISSIVE_HOLD
 
 #define MK_3_SPEED
 #define TAPPING_TOGGLE 1
 #define MK_W_OFFSET_1 2
 #define MK_W_OFFSET_0 15
-#define PS2_MOUSE_X_MULTIPLIER 2
-#define PS2_MOUSE_Y_MULTIPLIER 2
+#define PS2_MOUSE_ACCEL_BASE 0x0200 // Q8.8 gain of the slowest push, the x2 of the old multipliers
+#define PS2_MOUSE_ACCEL_SLOPE 0x0010 // Q8.8 gain added per count of speed
+#define PS2_MOUSE_ACCEL_MAX 0x0400 // Q8.8 gain cap, above the 0x03F0 the curve reaches at 31 counts per sample
 
 #if MY_TRACKPOINT_ENABLE
     #define PS2_PIO_USE_PIO1
@@ -36,6 +40,11 @@ SPDX-License-Identifier: GPL-2.0-or-later
     #define AUTO_MOUSE_TIME 500 // milliseconds
 #endif
 
+#if MY_GAME_PROFILE_ENABLE
+    #define SPLIT_LAYER_STATE_ENABLE // the eager release of custom_debounce.c runs on the slave too
+    #define RETRO_TAPPING_PER_KEY // the tap of the mod-tap keys in the game profile
+#endif
+
 #if MY_UNICODE_ENABLE
     #define UNICODE_SELECTED_MODES UNICODE_MODE_LINUX, UNICODE_MODE_MACOS, UNICODE_MODE_WINCOMPOSE
     #define OS_DETECTION_SINGLE_REPORT
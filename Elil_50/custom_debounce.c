@@ -0,0 +1,112 @@
+/*
+This is the c file of the custom debounce (DEBOUNCE_TYPE = custom), it implements QMK's debounce.h
+
+A switch bounces when its contacts meet and when they part, but it never reads closed before it is pressed:
+the first closed reading is already the press. So each key is debounced on its own and asymmetrically:
+- a press is registered at the first scan that sees it;
+- a release is registered once the key has read open for DEBOUNCE ms in a row, a bounce back closed starts it over.
+The bounce of a press is then only a release that never gets to wait long enough,
+and the bounce of a release is over before it is registered, so neither needs a lock.
+In the game profile the release is eager too, and each edge locks the key for DEBOUNCE ms instead,
+so a stop in the game is not DEBOUNCE ms late.
+The timer of each key is a nibble counting the ms left, two keys to a byte: 24 bytes for the 8x6 split matrix,
+which holds the 42 keys. Each half runs it on its own rows, so the slave needs the layer state to know the profile.
+debounce_sim.py in the repo root runs this file, built for the computer by host/debounce_host.c, against generated bounce.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "debounce.h"
+#include "scan_profile.h" // its marks compile to nothing without MY_PROFILE_ENABLE
+#if MY_GAME_PROFILE_ENABLE
+    #include "game_profile.h"
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+_Static_assert(DEBOUNCE > 0 && DEBOUNCE < 15, "DEBOUNCE + 1 must fit a nibble");
+
+#define KEYS (MATRIX_ROWS * MATRIX_COLS)
+
+// ms left for each key, 0 when idle: a release waiting for DEBOUNCE ms open, or the lock of the game profile
+static uint8_t  timers[(KEYS + 1) / 2];
+static uint8_t  counting = 0; // keys with a timer running, the walk is skipped when none is and nothing moved
+static uint16_t last_time;
+
+
+static uint8_t timer_get(uint8_t key) {
+    return key & 1 ? timers[key / 2] >> 4 : timers[key / 2] & 0x0F;
+}
+
+static void timer_set(uint8_t key, uint8_t ms) {
+    if (!timer_get(key) != !ms) counting += ms ? 1 : -1;
+    timers[key / 2] = key & 1 ? (timers[key / 2] & 0x0F) | (ms << 4) : (timers[key / 2] & 0xF0) | ms;
+}
+
+void debounce_init(uint8_t num_rows) {
+    memset(timers, 0, sizeof(timers));
+    counting  = 0;
+    last_time = timer_read();
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    scan_profile_mark(PROF_MATRIX); // the matrix read
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+    if (!changed && !counting) { // cooked already equals raw: no edge is left unhandled
+        scan_profile_mark(PROF_DEBOUNCE);
+        return false;
+    }
+
+#if MY_GAME_PROFILE_ENABLE
+    bool eager = game_profile_active();
+#else
+    bool eager = false;
+#endif
+    bool cooked_changed = false;
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t      key     = row * MATRIX_COLS + col;
+            matrix_row_t mask    = (matrix_row_t)1 << col;
+            bool         closed  = raw[row] & mask;
+            bool         pressed = cooked[row] & mask;
+            uint8_t      left    = timer_get(key);
+
+            if (left) {
+                bool releasing = pressed && !eager; // else a lock
+                if (releasing && closed) {
+                    timer_set(key, 0); // bounced back closed: still pressed
+                    continue;
+                }
+                if (left > elapsed) {
+                    timer_set(key, left - elapsed);
+                    continue;
+                }
+                timer_set(key, 0);
+                if (releasing) { // open for DEBOUNCE ms
+                    cooked[row] &= ~mask;
+                    cooked_changed = true;
+                    continue;
+                }
+            }
+
+            if (closed == pressed) continue;
+            if (closed || eager) {
+                cooked[row] ^= mask;
+                cooked_changed = true;
+            }
+            if (!closed || eager) timer_set(key, DEBOUNCE + 1); // a full DEBOUNCE ms, whatever the phase of the ms clock
+        }
+    }
+    scan_profile_mark(PROF_DEBOUNCE);
+    return cooked_changed;
+}
+
+void debounce_free(void) {}
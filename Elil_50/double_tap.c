@@ -0,0 +1,104 @@
+/*
+This is the c file of the double tap resolver
+
+QMK only knows a tap was single once its tap count can no longer grow, so the single tap action has to wait.
+Each key here waits only as long as the result is unknown:
+- the press of any other key makes the pending tap single (QMK restarts its tap count), so it fires right away,
+  before that key is processed;
+- otherwise it fires when the window of the key closes. The window starts at DOUBLE_TAP_WINDOW and then follows
+  the measured time between the two taps of the double taps: 1.5 times their average,
+  between DOUBLE_TAP_WINDOW_MIN and DOUBLE_TAP_WINDOW, within the tapping term: it only ever shortens the wait.
+A second tap that comes after the window still runs the double tap action, after the single one.
+QMK counts a second tap only within the quick tap term, 0 in config.h: the keys here get their tapping term.
+The deferred token is cleared by the callback itself, so a stale token is never cancelled:
+QMK reuses token numbers, and that could cancel somebody else's callback.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "double_tap.h"
+
+
+uint16_t double_tap_window(double_tap_t *tap, keyrecord_t *record) {
+    uint16_t term   = GET_TAPPING_TERM(tap->keycode, record);
+    uint16_t window = tap->gap ? tap->gap + tap->gap / 2 : DOUBLE_TAP_WINDOW;
+
+    if (window < DOUBLE_TAP_WINDOW_MIN) window = DOUBLE_TAP_WINDOW_MIN;
+    if (window > DOUBLE_TAP_WINDOW) window = DOUBLE_TAP_WINDOW;
+    if (window > term) window = term;
+    return window;
+}
+
+uint16_t double_tap_quick_tap_term(double_tap_t *taps, uint8_t count, uint16_t keycode, keyrecord_t *record) {
+    for (double_tap_t *tap = taps; tap < taps + count; tap++) {
+        if (tap->keycode == keycode) return GET_TAPPING_TERM(keycode, record); // a tap then a hold repeats the tap, as QMK's default
+    }
+    return QUICK_TAP_TERM;
+}
+
+static void fire_single(double_tap_t *tap) {
+    tap->pending = false;
+    tap->single(tap->time);
+}
+
+static uint32_t window_closed(uint32_t trigger_time, void *cb_arg) {
+    double_tap_t *tap = cb_arg;
+    tap->token = INVALID_DEFERRED_TOKEN; // it is spent: never cancel it
+    fire_single(tap);
+    return 0;
+}
+
+void double_tap_flush(double_tap_t *taps, uint8_t count) {
+    for (double_tap_t *tap = taps; tap < taps + count; tap++) {
+        if (!tap->pending) continue;
+
+        cancel_deferred_exec(tap->token);
+        tap->token = INVALID_DEFERRED_TOKEN;
+        fire_single(tap);
+    }
+}
+
+static void measure_gap(double_tap_t *tap, uint16_t gap) {
+    tap->gap = tap->gap ? tap->gap + ((int16_t)(gap - tap->gap) >> 2) : gap; // average of about the last 4
+}
+
+bool double_tap_process(double_tap_t *taps, uint8_t count, uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return true;
+
+    double_tap_t *tap = taps;
+    while (tap < taps + count && tap->keycode != keycode) tap++;
+
+    if (tap == taps + count || !record->tap.count) { // another key, or a hold: no tap can follow
+        double_tap_flush(taps, count);
+        return true;
+    }
+
+    if (record->tap.count == 1) {
+        double_tap_flush(taps, count); // the taps of the other keys are single, and so is an older one QMK did not count
+        tap->pending = true;
+        tap->time    = record->event.time;
+        tap->start   = timer_read();
+        tap->token   = defer_exec(double_tap_window(tap, record), window_closed, tap);
+        if (tap->token == INVALID_DEFERRED_TOKEN) {
+            fire_single(tap); // no executor left: do not lose the tap
+        }
+        return false;
+    }
+
+    for (double_tap_t *other = taps; other < taps + count; other++) {
+        if (other != tap) double_tap_flush(other, 1);
+    }
+    if (record->tap.count == 2) {
+        measure_gap(tap, timer_elapsed(tap->start));
+    }
+    if (tap->pending) {
+        cancel_deferred_exec(tap->token);
+        tap->token   = INVALID_DEFERRED_TOKEN;
+        tap->pending = false;
+    }
+    tap->dual(tap->time); // every further tap too, as before
+    return false;
+}
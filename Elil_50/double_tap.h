@@ -0,0 +1,46 @@
+/*
+This is the header of the double tap resolver: it tells one tap of a tap-hold key from two, without a fixed wait
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+#include "deferred_exec.h"
+
+// window of a key that has not been double tapped yet, ms after the first tap
+#ifndef DOUBLE_TAP_WINDOW
+#    define DOUBLE_TAP_WINDOW 100
+#endif
+
+// the measured windows stay between this and DOUBLE_TAP_WINDOW, and within the tapping term of the key,
+// past which QMK counts no second tap: a single tap never waits longer than with the fixed window
+#ifndef DOUBLE_TAP_WINDOW_MIN
+#    define DOUBLE_TAP_WINDOW_MIN 40
+#endif
+
+typedef void (*double_tap_action_t)(uint16_t time); // time: matrix edge of the first tap
+
+typedef struct {
+    uint16_t            keycode; // a mod-tap or layer-tap key
+    double_tap_action_t single;
+    double_tap_action_t dual;
+    deferred_token      token;   // valid only while pending
+    bool                pending; // one tap seen, the second may still come
+    uint16_t            time;    // of the pending tap
+    uint16_t            start;   // when the pending tap reached process_record_user
+    uint16_t            gap;     // average ms between the two taps of a double tap, 0 until one is seen
+} double_tap_t;
+
+#define DOUBLE_TAP(kc, single_action, dual_action) \
+    { .keycode = (kc), .single = (single_action), .dual = (dual_action), .token = INVALID_DEFERRED_TOKEN }
+
+bool     double_tap_process(double_tap_t *taps, uint8_t count, uint16_t keycode, keyrecord_t *record); // call from process_record_user, false: the event was a tap it took
+void     double_tap_flush(double_tap_t *taps, uint8_t count);                                          // fire the pending single taps now
+uint16_t double_tap_window(double_tap_t *tap, keyrecord_t *record);                                   // current window of a key, ms
+uint16_t double_tap_quick_tap_term(double_tap_t *taps, uint8_t count, uint16_t keycode, keyrecord_t *record); // call from get_quick_tap_term
@@ -0,0 +1,51 @@
+/*
+This is the c file of the game profile
+
+The game layers only need raw keys, fast. While one of them is the highest active layer:
+- combos and key overrides are switched off with QMK's own switches, so each event costs one check
+  instead of the combo buffer and the override walk; the keymap skips their index scans as well;
+- the keymap resolves mod-tap keys as holds at once (tapping term 0), with retro tapping for their tap;
+- custom_debounce.c registers releases as soon as they are seen too, not only presses.
+The layer state is read directly, so the profile also follows the plain layer_state assignments of the
+layer toggles, which skip layer_state_set_user. The slave half gets it with SPLIT_LAYER_STATE_ENABLE.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "game_profile.h"
+
+static uint8_t       game_layer = MAX_LAYER; // no game until init
+static layer_state_t seen_state = 0;
+static bool          active = false;
+static bool          applied = false; // what combos and key overrides were last switched to
+
+
+void game_profile_init(uint8_t first_layer) {
+    game_layer = first_layer;
+    seen_state = ~layer_state; // evaluate at the first call
+}
+
+bool game_profile_active(void) {
+    if (layer_state != seen_state) {
+        seen_state = layer_state;
+        active     = get_highest_layer(layer_state) >= game_layer;
+    }
+    return active;
+}
+
+bool game_profile_task(void) {
+    if (game_profile_active() == applied) return false;
+
+    applied = active;
+    if (active) {
+        combo_disable(); // also sends the keys it was buffering
+        key_override_off();
+    } else {
+        combo_enable();
+        key_override_on();
+    }
+    return true;
+}
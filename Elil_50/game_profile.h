@@ -0,0 +1,16 @@
+/*
+This is the header of the game profile: it strips the typing features while a game layer is on top
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void game_profile_init(uint8_t first_layer); // call from keyboard_post_init_user on both halves: layers from first_layer on are games
+bool game_profile_active(void);              // the highest active layer is a game, cheap enough for every scan
+bool game_profile_task(void);                // call before the events are processed: switches combos and key overrides on a change, true if it did
@@ -0,0 +1,205 @@
+/*
+This is the c file of the key override index
+
+QMK evaluates every entry of key_overrides[] on each key event and on each mod change.
+Here key_override_count() and key_override_get() are overridden to expose only the eligible overrides:
+- at boot, each matrix position gets the overrides triggered by any keycode it holds on any layer,
+  and the overrides triggered by a combo output are collected apart;
+- an override is eligible when one of its triggers is held (or a combo key is held, for combo outputs)
+  and its trigger mods intersect the mods that are active or held on a mod key;
+- the list is rebuilt only when the held positions or that mods mask change.
+QMK tracks the active override by pointer, so the list can change between two events.
+key_override_index_firing() tells process_record_user which override a press is about to activate:
+QMK runs the overrides after it, and the eligible list holds the few that can.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "key_override_index.h"
+#include "combo_index.h"
+
+#define KEY_OVERRIDE_INDEX_MAX 64 // one bit each in a uint64_t
+
+static uint64_t pos_overrides[MATRIX_ROWS][MATRIX_COLS]; // overrides each position can trigger
+static uint8_t  pos_mods[MATRIX_ROWS][MATRIX_COLS];      // mods each position can hold down
+static uint64_t combo_overrides;                         // overrides triggered by a combo output
+static bool     index_ready = false;
+
+static matrix_row_t previous[MATRIX_ROWS];
+static uint64_t     held_overrides = 0;
+static uint8_t      held_mods = 0;
+static bool         dirty = true;
+
+static uint8_t eligible[KEY_OVERRIDE_INDEX_MAX]; // raw override indices
+static uint8_t eligible_len = 0;
+static uint8_t eligible_mods = 0;
+
+static uint32_t index_events = 0;
+static uint32_t index_visits = 0;
+
+
+// 8 bit mods mask of a modifier or mod-tap keycode
+static uint8_t keycode_mods(uint16_t keycode) {
+    if (IS_MODIFIER_KEYCODE(keycode)) {
+        return MOD_BIT(keycode);
+    }
+    if (IS_QK_MOD_TAP(keycode)) {
+        uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+        return (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+    }
+    return 0;
+}
+
+void key_override_index_init(void) {
+    uint16_t count = key_override_count_raw();
+    if (count > KEY_OVERRIDE_INDEX_MAX) {
+        dprintf("key_override_index: %u overrides, too many for the index\n", count);
+        return; // fall back to the full table
+    }
+
+    uint8_t layers = keymap_layer_count();
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            for (uint8_t layer = 0; layer < layers; layer++) {
+                uint16_t keycode = keycode_at_keymap_location(layer, row, col);
+                if (keycode == KC_NO || keycode == KC_TRNS) continue;
+
+                pos_mods[row][col] |= keycode_mods(keycode);
+                for (uint16_t idx = 0; idx < count; idx++) {
+                    const key_override_t *override = key_override_get_raw(idx);
+                    if (override != NULL && override->trigger == keycode) {
+                        pos_overrides[row][col] |= (uint64_t)1 << idx;
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint16_t combo_idx = 0; combo_idx < combo_count_raw(); combo_idx++) {
+        uint16_t keycode = combo_get_raw(combo_idx)->keycode;
+        for (uint16_t idx = 0; idx < count; idx++) {
+            const key_override_t *override = key_override_get_raw(idx);
+            if (override != NULL && override->trigger == keycode) {
+                combo_overrides |= (uint64_t)1 << idx;
+            }
+        }
+    }
+    index_ready = true;
+}
+
+// the overrides and the mods the held positions can trigger
+static void collect_held(void) {
+    held_overrides = combo_index_active() ? combo_overrides : 0;
+    held_mods = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t current = previous[row];
+        for (uint8_t col = 0; current; col++, current >>= 1) {
+            if (current & 1) {
+                held_overrides |= pos_overrides[row][col];
+                held_mods |= pos_mods[row][col];
+            }
+        }
+    }
+    dirty = true;
+}
+
+void key_override_index_scan(void) {
+    if (!index_ready) return;
+
+    bool changed = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t current = matrix_get_row(row);
+        changed |= current != previous[row];
+        index_events += __builtin_popcount(current ^ previous[row]);
+        previous[row] = current;
+    }
+    if (changed) collect_held();
+}
+
+void key_override_index_resync(void) {
+    if (!index_ready) return;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        previous[row] = matrix_get_row(row);
+    }
+    collect_held();
+}
+
+static void rebuild(uint8_t mods) {
+    eligible_len = 0;
+    for (uint8_t idx = 0; idx < KEY_OVERRIDE_INDEX_MAX; idx++) {
+        if (!(held_overrides & ((uint64_t)1 << idx))) continue;
+
+        const key_override_t *override = key_override_get_raw(idx);
+        if (override->trigger_mods == 0 || (override->trigger_mods & mods)) {
+            eligible[eligible_len++] = idx;
+        }
+    }
+    eligible_mods = mods;
+    dirty = false;
+}
+
+uint16_t key_override_count(void) {
+    if (!index_ready) return key_override_count_raw();
+
+    // mods that are active, or that a held key may still activate
+    uint8_t mods = get_mods() | get_weak_mods() | held_mods;
+#ifndef NO_ACTION_ONESHOT
+    mods |= get_oneshot_mods();
+#endif
+    if (dirty || mods != eligible_mods) {
+        rebuild(mods);
+    }
+    return eligible_len;
+}
+
+const key_override_t *key_override_get(uint16_t key_override_idx) {
+    index_visits++;
+    return key_override_get_raw(index_ready ? eligible[key_override_idx] : key_override_idx);
+}
+
+// QMK's check: each kind of trigger mod (ctrl, shift, alt, gui) active on either side, or any of them with ko_option_one_mod
+static bool mods_match(const key_override_t *override, uint8_t mods) {
+    if (mods & override->negative_mod_mask) return false;
+    if (override->options & ko_option_one_mod) return mods & override->trigger_mods;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t side_mods = 0x11 << i;
+        if ((override->trigger_mods & side_mods) && !(mods & side_mods)) return false;
+    }
+    return true;
+}
+
+const key_override_t *key_override_index_firing(uint16_t keycode) {
+    if (!key_override_is_enabled()) return NULL;
+
+    // QMK strips the mods suppressed by an active override from the report only, get_mods() still has them
+    uint8_t mods = get_mods();
+#ifndef NO_ACTION_ONESHOT
+    mods |= get_oneshot_mods();
+#endif
+    uint8_t layer = get_highest_layer(layer_state | default_layer_state);
+
+    uint16_t count = key_override_count(); // brings the eligible list up to date
+    for (uint16_t idx = 0; idx < count; idx++) {
+        const key_override_t *override = key_override_get_raw(index_ready ? eligible[idx] : idx);
+        if (override == NULL || override->trigger != keycode) continue;
+        if (!(override->options & ko_option_activation_trigger_down)) continue;
+        if (!(override->layers & ((layer_state_t)1 << layer))) continue;
+        if (override->enabled != NULL && !*override->enabled) continue;
+        if (mods_match(override, mods)) return override;
+    }
+    return NULL;
+}
+
+void key_override_index_dump(void) {
+    // without the index every event walks the whole table
+    uprintf("override index: events=%lu overrides/event before=%u after=%lu.%02lu\n", index_events, key_override_count_raw(),
+            index_events ? index_visits / index_events : 0, index_events ? (index_visits * 100 / index_events) % 100 : 0);
+    index_events = 0;
+    index_visits = 0;
+}
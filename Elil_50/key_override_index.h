@@ -0,0 +1,18 @@
+/*
+This is the header of the key override index: it narrows the overrides QMK evaluates on each event
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include "process_key_override.h"
+
+void key_override_index_init(void);                                      // call once the keymap is readable (keyboard_post_init_user)
+void key_override_index_scan(void);                                      // call from matrix_scan_user, before the events are processed
+void key_override_index_resync(void);                                    // call when key overrides come back on after scans that skipped the scan
+const key_override_t *key_override_index_firing(uint16_t keycode);       // the override the press of keycode activates, NULL if none
+void key_override_index_dump(void);                                      // console report of the evaluation cost
@@ -0,0 +1,110 @@
+/*
+This is the c file of the key trace
+
+Tuning the tapping terms and PERMISSIVE_HOLD needs real typing, not guesses.
+Every matrix event is recorded at pre_process_record_user, before combos and tap-hold buffer it:
+its matrix edge time, position, direction and the keycode of the layer stack.
+When the same event later reaches process_record_user, its entry gets what the keymap made of it
+(plain key, tap or hold) and how long it waited; combo actions get an entry of their own.
+Events a combo ate never get there and stay pending.
+The ring keeps the last KEY_TRACE_SIZE events and is read out with key_trace_dump() on the console,
+or over raw HID by telemetry_reader.py --trace, which writes the replay file.
+It holds whatever was typed, passwords included, and never leaves the RAM by itself:
+keep MY_TRACE_ENABLE off when not tuning.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "key_trace.h"
+
+_Static_assert((KEY_TRACE_SIZE & (KEY_TRACE_SIZE - 1)) == 0, "KEY_TRACE_SIZE must be a power of two");
+
+#define KEY_TRACE_SEARCH 32 // how far back an event is looked for: tap-hold and combos buffer only a few
+
+static key_trace_event_t trace[KEY_TRACE_SIZE];
+static uint16_t          head = 0;  // next entry to write
+static uint16_t          count = 0; // up to KEY_TRACE_SIZE
+static bool              paused = false;
+
+
+static key_trace_event_t *push(void) {
+    key_trace_event_t *event = &trace[head];
+    head = (head + 1) & (KEY_TRACE_SIZE - 1);
+    if (count < KEY_TRACE_SIZE) count++;
+    return event;
+}
+
+void key_trace_edge(uint16_t keycode, keyrecord_t *record) {
+    if (paused || record->event.type != KEY_EVENT) return;
+
+    key_trace_event_t *event = push();
+    event->time    = record->event.time;
+    event->row     = record->event.key.row;
+    event->col     = record->event.key.col;
+    event->keycode = keycode;
+    event->flags   = record->event.pressed ? KEY_TRACE_PRESSED : 0;
+    event->delay   = 0;
+}
+
+void key_trace_resolve(uint16_t keycode, keyrecord_t *record) {
+    if (paused) return;
+
+    uint16_t waited  = timer_elapsed(record->event.time);
+    uint8_t  delay   = waited > UINT8_MAX ? UINT8_MAX : waited;
+    uint8_t  pressed = record->event.pressed ? KEY_TRACE_PRESSED : 0;
+
+    if (record->event.type == COMBO_EVENT) {
+        key_trace_event_t *event = push();
+        event->time    = record->event.time;
+        event->row     = KEY_TRACE_COMBO_ROW;
+        event->col     = KEY_TRACE_COMBO_ROW;
+        event->keycode = keycode;
+        event->flags   = pressed | KEY_TRACE_COMBO;
+        event->delay   = delay;
+        return;
+    }
+
+    uint8_t resolution = KEY_TRACE_PLAIN;
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        resolution = record->tap.count ? KEY_TRACE_TAP : KEY_TRACE_HOLD;
+    }
+
+    // the entry of this very event: same edge, position and direction, not resolved yet
+    uint16_t i = head;
+    for (uint16_t n = 0; n < count && n < KEY_TRACE_SEARCH; n++) {
+        i = (i - 1) & (KEY_TRACE_SIZE - 1);
+        key_trace_event_t *event = &trace[i];
+        if (event->time == record->event.time && event->row == record->event.key.row && event->col == record->event.key.col && (event->flags & KEY_TRACE_PRESSED) == pressed && KEY_TRACE_RESOLUTION(event->flags) == KEY_TRACE_PENDING) {
+            event->flags |= resolution;
+            event->delay = delay;
+            return;
+        }
+    }
+}
+
+void key_trace_pause(bool pause) {
+    paused = pause;
+}
+
+uint16_t key_trace_count(void) {
+    return count;
+}
+
+bool key_trace_get(uint16_t index, key_trace_event_t *event) {
+    if (index >= count) return false;
+
+    *event = trace[(head - count + index) & (KEY_TRACE_SIZE - 1)];
+    return true;
+}
+
+void key_trace_dump(void) {
+    key_trace_event_t event;
+
+    uprintf("kt v1 %u events\n", count);
+    for (uint16_t i = 0; key_trace_get(i, &event); i++) {
+        uprintf("kt %u %u %u %c %04X %u %u\n", event.time, event.row, event.col, (event.flags & KEY_TRACE_PRESSED) ? 'd' : 'u', event.keycode, KEY_TRACE_RESOLUTION(event.flags), event.delay);
+    }
+}
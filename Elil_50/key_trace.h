@@ -0,0 +1,48 @@
+/*
+This is the header of the key trace: it keeps the last key events in RAM, to replay real typing on the host
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+
+// a power of two, 8 bytes each
+#ifndef KEY_TRACE_SIZE
+#    define KEY_TRACE_SIZE 256
+#endif
+
+#define KEY_TRACE_COMBO_ROW 0xFE // row and col of the combo actions, as QMK's KEYLOC_COMBO
+
+// what the keymap made of the event, filled in when it reaches process_record_user
+enum key_trace_resolution {
+    KEY_TRACE_PENDING, // never reached it: eaten by a combo, or still buffered at the dump
+    KEY_TRACE_PLAIN,   // a key without tap-hold
+    KEY_TRACE_TAP,     // a tap-hold key resolved as tap
+    KEY_TRACE_HOLD,    // a tap-hold key resolved as hold
+    KEY_TRACE_COMBO,   // a combo action, on its own row
+};
+
+typedef struct {
+    uint16_t time;    // matrix edge, QMK 16 bit ms clock
+    uint8_t  row;
+    uint8_t  col;
+    uint16_t keycode; // of the layer stack at the edge, or the combo keycode
+    uint8_t  flags;   // bit 7 pressed, bits 0-2 enum key_trace_resolution
+    uint8_t  delay;   // ms from the edge to process_record_user, saturated
+} key_trace_event_t;
+
+#define KEY_TRACE_PRESSED 0x80
+#define KEY_TRACE_RESOLUTION(flags) ((flags) & 0x07)
+
+void key_trace_edge(uint16_t keycode, keyrecord_t *record);    // call from pre_process_record_user: every matrix event, before combos and tap-hold
+void key_trace_resolve(uint16_t keycode, keyrecord_t *record); // call from process_record_user with every event
+void key_trace_pause(bool pause);                              // stop recording, e.g. while the trace is read out
+uint16_t key_trace_count(void);                                // events in the trace
+bool     key_trace_get(uint16_t index, key_trace_event_t *event); // index 0 is the oldest
+void     key_trace_dump(void);                                  // console dump, one "kt" line per event, see telemetry_reader.py
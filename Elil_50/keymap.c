@@ -6,10 +6,34 @@
 */
 
 #include QMK_KEYBOARD_H
+#include "combo_index.h"
+#include "key_override_index.h"
+#include "scan_profile.h" // its marks compile to nothing without MY_PROFILE_ENABLE
+#include "double_tap.h"
+#include "tapping_term.h"
+#include "layer_cache.h"
+#include "overlay_layer.h"
+
+#if MY_UNICODE_ENABLE
+    #include "unicode_queue.h"
+#endif
+
+#if MY_TELEMETRY_ENABLE
+    #include "telemetry.h"
+#endif
+
+#if MY_TRACE_ENABLE
+    #include "key_trace.h"
+#endif
+
+#if MY_GAME_PROFILE_ENABLE
+    #include "game_profile.h"
+#endif
 
 #if MY_TRACKPOINT_ENABLE
     #include "drivers/sensors/ps2_mouse.h"
     #include "ps2.h"
+    #include "trackpoint.h"
 #endif
 
 // #define MY_UNICODE_ENABLE 1  // it's in rules.mk
@@ -40,6 +64,9 @@
 #define MOUSE_LAYER (GREEK_LAYER+ADD_MOUSE) // only if trackpoint is enabled
 #define SCROLL_LAYER (MOUSE_LAYER+1)
 #define ADD_LAYER (SCROLL_LAYER+1) // These are the user layers
+#define OVERLAY_LAYERS (ADD_MOUSE+1) // mouse and scroll layers, stored sparse: see overlay_layer.c
+#define FIRST_OVERLAY (ADD_LAYER-OVERLAY_LAYERS)
+#define DENSE_LAYER(layer) ((layer)-OVERLAY_LAYERS) // index in keymaps[] of a layer after the overlays
 
 
 
@@ -49,6 +76,9 @@
 
 enum new_keys {
     ACCEL = SAFE_RANGE,
+    LAT_DUMP,
+    TP_DOWN, // trackpoint sensitivity down, speed with shift
+    TP_UP, // trackpoint sensitivity up, speed with shift
 };
 
 #define MY_LESS S(KC_COMM)
@@ -71,6 +101,20 @@ enum new_keys {
     #define MY_EXIST XXXXXXX
 #endif
 
+#if MY_LATENCY_STATS_ENABLE || MY_PROFILE_ENABLE || MY_TRACE_ENABLE
+    #define MY_LAT_DUMP LAT_DUMP
+#else
+    #define MY_LAT_DUMP XXXXXXX
+#endif
+
+#if MY_TRACKPOINT_ENABLE
+    #define MY_TP_DOWN TP_DOWN
+    #define MY_TP_UP TP_UP
+#else
+    #define MY_TP_DOWN XXXXXXX
+    #define MY_TP_UP XXXXXXX
+#endif
+
 
 
 //    %----------------------%
@@ -116,34 +160,28 @@ bool process_detected_host_os_kb(os_variant_t detected_os) {
 // Threshold Press to select: Adress: 0xE2 0x81 0x5C, value: 0 - 255 in hex. Default: 0x08
 
 #if MY_TRACKPOINT_ENABLE
-void pointing_device_init_user() {
-    PS2_MOUSE_SEND(0xE2, "tpspeed: 0xE2"); //address
-    PS2_MOUSE_SEND(0x81, "tpspeed: 0x81"); //address
-    PS2_MOUSE_SEND(0x60, "tpspeed: 0x60"); // address
-    PS2_MOUSE_SEND(0xFF, "tpspeed: 0xFF"); // value
-
-    PS2_MOUSE_SEND(0xE2, "tpsens: 0xE2"); //address
-    PS2_MOUSE_SEND(0x81, "tpsens: 0x81"); //address
-    PS2_MOUSE_SEND(0x4A, "tpsens: 0x4A"); // address
-    PS2_MOUSE_SEND(0xB4, "tpsens: 0xFF"); // value
+// written in this order, and kept in RAM: the adjust keys step the values of this table
+static trackpoint_register_t trackpoint_registers[] = {
+    {TP_REG_SPEED, 0xFF},
+    {TP_REG_SENSITIVITY, 0xB4},
 
     // I tried enabling press to click, but the Z sensitivity is low even when maxed out
 
-    // PS2_MOUSE_SEND(0xE2, "ptson: 0xE2"); //address
-    // PS2_MOUSE_SEND(0x47, "ptson: 0x47"); //address
-    // PS2_MOUSE_SEND(0x2C, "ptson: 0x2C"); // address
-    // PS2_MOUSE_SEND(0x01, "ptson: 0x01"); // value
-    // PS2_MOUSE_SEND(0xE2, "ptson_thr: 0xE2"); // address
-    // PS2_MOUSE_SEND(0x81, "ptson_thr: 0x81"); //address
-    // PS2_MOUSE_SEND(0x5C, "ptson_thr: 0x5C"); // address
-    // PS2_MOUSE_SEND(0xFF, "ptson_thr: 0xFF"); // value
-    // PS2_MOUSE_SEND(0xE2, "ptson_thr: 0xE2"); // address
-    // PS2_MOUSE_SEND(0x81, "ptson_thr: 0x81"); //address
-    // PS2_MOUSE_SEND(0x58, "ptson_thr: 0x5C"); // address
-    // PS2_MOUSE_SEND(0x00, "ptson_thr: 0xFF"); // value
+    // {TP_REG_PTS_TOGGLE, 0x01},
+    // {TP_REG_PTS_THRESHOLD, 0xFF},
+    // {0x58, 0x00},
+};
+
+// the driver brings the trackpoint up after boot and again after each recovery of its watchdog:
+// one register per pointing device task once it answers, only those it lost are written again
+bool ps2_mouse_configure_user(void) {
+    return trackpoint_apply_step();
+}
 
+void pointing_device_init_user() {
     set_auto_mouse_layer(MOUSE_LAYER);
     set_auto_mouse_enable(true);
+    trackpoint_apply(trackpoint_registers, sizeof(trackpoint_registers) / sizeof(trackpoint_registers[0]));
 }
 # endif
 
@@ -154,170 +192,58 @@ void pointing_device_init_user() {
 //    %-------------%
 #if MY_UNICODE_ENABLE
 
+// symbols whose codepoints follow their unicode_name order: one base codepoint per run (BMP only),
+// the runs and the exceptions below feed the compiler only: unicode_hid[] is the one table in flash
+#define UNICODE_RANGES(R, X) \
+    /* greek letters, U+03A2 is unassigned */ \
+    R(UALPH, 0x0391) X(UALPH) X(UBETA) X(UGAMM) X(UDELT) X(UEPSI) X(UZETA) X(UETA) X(UTHET) X(UIOTA) \
+        X(UKAPP) X(ULAMB) X(UMU) X(UNU) X(UXI) X(UOMIC) X(UPI) X(URHO) \
+    R(USIGM, 0x03A3) X(USIGM) X(UTAU) X(UUPSI) X(UPHI) X(UCHI) X(UPSI) X(UOMEG) \
+    R(LALPH, 0x03B1) X(LALPH) X(LBETA) X(LGAMM) X(LDELT) X(LEPSI) X(LZETA) X(LETA) X(LTHET) X(LIOTA) \
+        X(LKAPP) X(LLAMB) X(LMU) X(LNU) X(LXI) X(LOMIC) X(LPI) X(LRHO) X(FSIGM) X(LSIGM) X(LTAU) \
+        X(LUPSI) X(LPHI) X(LCHI) X(LPSI) X(LOMEG) \
+    /* subscript */ \
+    R(SUB_0, 0x2080) X(SUB_0) X(SUB_1) X(SUB_2) X(SUB_3) X(SUB_4) X(SUB_5) X(SUB_6) X(SUB_7) X(SUB_8) X(SUB_9)
+
+// symbols scattered over the BMP: one codepoint each
+#define UNICODE_EXCEPTIONS(E) \
+    E(LTEQ, 0x2264) /* less than or equal */ \
+    E(GTEQ, 0x2265) /* greater than or equal */ \
+    E(NOTEQ, 0x2260) /* not equal */ \
+    E(PLMIN, 0x00B1) /* plus minus */ \
+    E(FORALL, 0x2200) /* for all */ \
+    E(EUR, 0x20AC) \
+    E(LEFTARR, 0x2190) \
+    E(RIGHTARR, 0x2192) \
+    E(LEFTRIGHTARR, 0x2194) \
+    E(INTEGR, 0x222B) \
+    E(NABLA, 0x2207) \
+    E(ELEMOF, 0x2208) \
+    E(EXIST, 0x2203) \
+    E(INFTY, 0x221E)
+
+#define UNICODE_NAME(name, ...) name,
+#define UNICODE_NONE(...)
+#define UNICODE_RUN_CODEPOINT(first, base) unicode_run_##first = (base) - 1,
+#define UNICODE_EXCEPTION_CODEPOINT(name, codepoint) unicode_codepoint_##name = codepoint,
+#define UNICODE_NAME_CODEPOINT(name) unicode_codepoint_##name,
+#define UNICODE_SEQUENCE(name, ...) [name] = UNICODE_HID(unicode_codepoint_##name),
+
+// the index UM() and UP() take
 enum unicode_name {
-    // greek letters
-    UALPH,
-    UBETA,
-    UGAMM,
-    UDELT,
-    UEPSI,
-    UZETA,
-    UETA,
-    UTHET,
-    UIOTA,
-    UKAPP,
-    ULAMB,
-    UMU,
-    UNU,
-    UXI,
-    UOMIC,
-    UPI,
-    URHO,
-    USIGM,
-    UTAU,
-    UUPSI,
-    UPHI,
-    UCHI,
-    UPSI,
-    UOMEG,
-
-    LALPH,
-    LBETA,
-    LGAMM,
-    LDELT,
-    LEPSI,
-    LZETA,
-    LETA,
-    LTHET,
-    LIOTA,
-    LKAPP,
-    LLAMB,
-    LMU,
-    LNU,
-    LXI,
-    LOMIC,
-    LPI,
-    LRHO,
-    LSIGM,
-    LTAU,
-    LUPSI,
-    LPHI,
-    LCHI,
-    LPSI,
-    LOMEG,
-    FSIGM,
-
-    LTEQ,
-    GTEQ,
-    NOTEQ,
-    PLMIN,
-    FORALL,
-    EUR,
-    LEFTARR,
-    RIGHTARR,
-    LEFTRIGHTARR,
-    INTEGR,
-    NABLA,
-    ELEMOF,
-    EXIST,
-    INFTY,
-
-    SUB_0,
-    SUB_1,
-    SUB_2,
-    SUB_3,
-    SUB_4,
-    SUB_5,
-    SUB_6,
-    SUB_7,
-    SUB_8,
-    SUB_9,
-
+    UNICODE_EXCEPTIONS(UNICODE_NAME)
+    UNICODE_RANGES(UNICODE_NONE, UNICODE_NAME)
 };
 
+// codepoint of each symbol for the compiler only: in a run each one counts up from the base
+enum unicode_codepoints {
+    UNICODE_EXCEPTIONS(UNICODE_EXCEPTION_CODEPOINT)
+    UNICODE_RANGES(UNICODE_RUN_CODEPOINT, UNICODE_NAME_CODEPOINT)
+};
 
-const uint32_t unicode_map[] PROGMEM = {
-    // greek letters
-    [UALPH] = 0x0391,
-    [UBETA] = 0x0392,
-    [UGAMM] = 0x0393,
-    [UDELT] = 0x0394,
-    [UEPSI] = 0x0395,
-    [UZETA] = 0x0396,
-    [UETA] = 0x0397,
-    [UTHET] = 0x0398,
-    [UIOTA] = 0x0399,
-    [UKAPP] = 0x039A,
-    [ULAMB] = 0x039B,
-    [UMU] = 0x039C,
-    [UNU] = 0x039D,
-    [UXI] = 0x039E,
-    [UOMIC] = 0x039F,
-    [UPI] = 0x03A0,
-    [URHO] = 0x03A1,
-    [USIGM] = 0x03A3,
-    [UTAU] = 0x03A4,
-    [UUPSI] = 0x03A5,
-    [UPHI] = 0x03A6,
-    [UCHI] = 0x03A7,
-    [UPSI] = 0x03A8,
-    [UOMEG] = 0x03A9,
-
-    [LALPH] = 0x03B1,
-    [LBETA] = 0x03B2,
-    [LGAMM] = 0x03B3,
-    [LDELT] = 0x03B4,
-    [LEPSI] = 0x03B5,
-    [LZETA] = 0x03B6,
-    [LETA] = 0x03B7,
-    [LTHET] = 0x03B8,
-    [LIOTA] = 0x03B9,
-    [LKAPP] = 0x03BA,
-    [LLAMB] = 0x03BB,
-    [LMU] = 0x03BC,
-    [LNU] = 0x03BD,
-    [LXI] = 0x03BE,
-    [LOMIC] = 0x03BF,
-    [LPI] = 0x03C0,
-    [LRHO] = 0x03C1,
-    [LSIGM] = 0x03C3,
-    [LTAU] = 0x03C4,
-    [LUPSI] = 0x03C5,
-    [LPHI] = 0x03C6,
-    [LCHI] = 0x03C7,
-    [LPSI] = 0x03C8,
-    [LOMEG] = 0x03C9,
-
-    [FSIGM] = 0x03C2,
-
-    // other
-    [LTEQ] = 0x2264, // less than or equal
-    [GTEQ] = 0x2265, // greater than or equal
-    [NOTEQ] = 0x2260, // not equal
-    [PLMIN] = 0xB1, // plus minus
-    [FORALL] = 0x2200, // plus minus
-    [EUR] = 0x20AC,
-    [LEFTARR] = 0x2190,
-    [RIGHTARR] = 0x2192,
-    [LEFTRIGHTARR] = 0x2194,
-    [INTEGR] = 0x222B,
-    [NABLA] = 0x2207,
-    [ELEMOF] = 0x2208,
-    [EXIST] = 0x2203,
-    [INFTY] = 0x221E,
-
-    // subscript
-    [SUB_0] = 0x2080,
-    [SUB_1] = 0x2081,
-    [SUB_2] = 0x2082,
-    [SUB_3] = 0x2083,
-    [SUB_4] = 0x2084,
-    [SUB_5] = 0x2085,
-    [SUB_6] = 0x2086,
-    [SUB_7] = 0x2087,
-    [SUB_8] = 0x2088,
-    [SUB_9] = 0x2089,
-
+const unicode_hid_t unicode_hid[] PROGMEM = {
+    UNICODE_EXCEPTIONS(UNICODE_SEQUENCE)
+    UNICODE_RANGES(UNICODE_NONE, UNICODE_SEQUENCE)
 };
 
 #define ALPH UP(LALPH,UALPH)
@@ -355,13 +281,11 @@ const uint32_t unicode_map[] PROGMEM = {
 #if MY_UNICODE_ENABLE
 static bool send_unicode(bool activated, void *context) {
     if (activated) {
-    	uint8_t saved_mods = get_mods();
-    	unregister_mods(saved_mods); // temporarily clear user mods: we don't suppress them in MAKE_OVERRIDE
-
         uint32_t code = (uintptr_t)context;  // store UM(x) as integer in context
-        register_unicodemap(unicodemap_index(code));
-
-    	set_mods(saved_mods); // restore mods
+        unicode_queue_push(unicode_index(code)); // typed with the rest of the burst
+#if MY_TELEMETRY_ENABLE
+        telemetry_override();
+#endif
     }
     return false;
 }
@@ -406,25 +330,51 @@ const key_override_t my_overrides_33 = MAKE_UNICODE_OVERRIDE(MOD_MASK_SHIFT, MY_
 const key_override_t my_overrides_34 = MAKE_UNICODE_OVERRIDE(MOD_MASK_ALT, MY_INTEGR, UM(INFTY), 0);
 #endif
 
-const key_override_t override_1 = ko_make_basic(MOD_MASK_SHIFT, KC_LPRN, KC_RPRN);
-const key_override_t override_2 = ko_make_basic(MOD_MASK_SHIFT, KC_LBRC, KC_RBRC);
-const key_override_t override_3 = ko_make_basic(MOD_MASK_SHIFT, KC_LCBR, KC_RCBR);
-const key_override_t override_4 = ko_make_basic(MOD_MASK_SHIFT, KC_COMMA, KC_DOT);
-const key_override_t override_6 = ko_make_basic(MOD_MASK_SHIFT, KC_EQL, KC_TILD);
-const key_override_t override_9 = ko_make_basic(MOD_MASK_ALT, KC_PAST, KC_CIRC);
-const key_override_t override_10 = ko_make_basic(MOD_MASK_SHIFT, KC_HASH, KC_PERC);
-const key_override_t override_15 = ko_make_basic(MOD_MASK_ALT, KC_QUOTE, KC_GRV);
-const key_override_t override_17 = ko_make_basic(MOD_MASK_SHIFT, KC_LT, KC_GT);
-const key_override_t override_18 = ko_make_basic(MOD_MASK_SHIFT, KC_PPLS, KC_PMNS);
-const key_override_t override_20 = ko_make_basic(MOD_MASK_SHIFT, KC_SPC, KC_UNDS);
-const key_override_t override_21 = ko_make_basic(MOD_MASK_SHIFT, KC_ENTER, KC_TAB);
-const key_override_t override_22 = ko_make_basic(MOD_MASK_SHIFT, MY_LESS, MY_GREAT);
-const key_override_t override_23 = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
-const key_override_t override_24 = ko_make_basic(MOD_MASK_SHIFT, KC_AMPR, KC_AT);
-const key_override_t override_25 = ko_make_basic(MOD_MASK_SHIFT, KC_QUES, KC_EXLM);
-const key_override_t override_27 = ko_make_basic(MOD_MASK_SHIFT, KC_PAST, KC_SLASH);
-const key_override_t override_28 = ko_make_basic(MOD_MASK_CTRL, KC_VOLU, KC_VOLD);
-const key_override_t override_29 = ko_make_basic(MOD_MASK_CTRL, KC_BRIU, KC_BRID);
+#if MY_TELEMETRY_ENABLE
+static bool count_override(bool activated, void *context) {
+    if (activated) {
+        telemetry_override();
+    }
+    return true; // the replacement is registered as usual
+}
+
+// ko_make_basic() with a custom action that counts the override when it activates
+#define MAKE_BASIC_OVERRIDE(mods, trig, repl) \
+(const key_override_t){ \
+    .trigger_mods = mods, \
+    .layers = ~0, \
+    .options = ko_options_default, \
+    .negative_mod_mask = 0, \
+    .suppressed_mods = mods, \
+    .custom_action = count_override, \
+    .context = NULL, \
+    .trigger = trig, \
+    .replacement = repl, \
+    .enabled = NULL, \
+}
+#else
+#define MAKE_BASIC_OVERRIDE ko_make_basic
+#endif
+
+const key_override_t override_1 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_LPRN, KC_RPRN);
+const key_override_t override_2 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_LBRC, KC_RBRC);
+const key_override_t override_3 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_LCBR, KC_RCBR);
+const key_override_t override_4 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_COMMA, KC_DOT);
+const key_override_t override_6 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_EQL, KC_TILD);
+const key_override_t override_9 = MAKE_BASIC_OVERRIDE(MOD_MASK_ALT, KC_PAST, KC_CIRC);
+const key_override_t override_10 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_HASH, KC_PERC);
+const key_override_t override_15 = MAKE_BASIC_OVERRIDE(MOD_MASK_ALT, KC_QUOTE, KC_GRV);
+const key_override_t override_17 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_LT, KC_GT);
+const key_override_t override_18 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_PPLS, KC_PMNS);
+const key_override_t override_20 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_SPC, KC_UNDS);
+const key_override_t override_21 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_ENTER, KC_TAB);
+const key_override_t override_22 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, MY_LESS, MY_GREAT);
+const key_override_t override_23 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+const key_override_t override_24 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_AMPR, KC_AT);
+const key_override_t override_25 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_QUES, KC_EXLM);
+const key_override_t override_27 = MAKE_BASIC_OVERRIDE(MOD_MASK_SHIFT, KC_PAST, KC_SLASH);
+const key_override_t override_28 = MAKE_BASIC_OVERRIDE(MOD_MASK_CTRL, KC_VOLU, KC_VOLD);
+const key_override_t override_29 = MAKE_BASIC_OVERRIDE(MOD_MASK_CTRL, KC_BRIU, KC_BRID);
 
 const key_override_t *key_overrides[] = {
   &override_1,
@@ -878,34 +828,380 @@ combo_t key_combos[] = {
 
 
 
+//    %---------------%
+//    | LATENCY STATS |
+//    %---------------%
+
+// Added latency = time between the matrix edge and the moment process_record_user sees the event:
+// combo buffering, hold-tap resolution and deferred taps all end up here.
+// Enable MY_LATENCY_STATS_ENABLE in rules.mk, open "qmk console" and tap LAT_DUMP (layer 2):
+// it prints the numbers collected since the last dump and resets them.
+
+#if MY_LATENCY_STATS_ENABLE
+enum lat_kind {
+    LAT_PLAIN,    // keys that reach the pipeline directly
+    LAT_HOLD_TAP, // mod-tap and layer-tap keys, after tap/hold resolution
+    LAT_COMBO,    // combo actions, from the press that completed the chord
+    LAT_DEFERRED, // Home/End single taps waiting out the double tap window
+    LAT_KINDS
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+} lat_stat_t;
+
+static lat_stat_t lat_stats[LAT_KINDS];
+static uint16_t lat_last_press = 0; // matrix edge of the latest press
+static uint32_t lat_keyboard_reports = 0;
+static uint32_t lat_mouse_reports = 0;
+static uint32_t lat_keys_ready = 0; // ms from boot to the first matrix scan
+
+static void lat_record(uint8_t kind, uint16_t elapsed) {
+    lat_stat_t *stat = &lat_stats[kind];
+    if (!stat->count || elapsed < stat->min) stat->min = elapsed;
+    if (elapsed > stat->max) stat->max = elapsed;
+    stat->sum += elapsed;
+    stat->count++;
+}
+
+// QMK sets the lowest bit of the event time so it is never 0: an event of this ms can be 1 ms ahead of the timer
+static uint16_t lat_since(uint16_t time) {
+    uint16_t elapsed = timer_elapsed(time);
+    return elapsed == UINT16_MAX ? 0 : elapsed;
+}
+
+static void lat_process_record(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return;
+
+    if (record->event.type == COMBO_EVENT) {
+        lat_record(LAT_COMBO, timer_elapsed(lat_last_press));
+    } else if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        lat_record(LAT_HOLD_TAP, lat_since(record->event.time));
+    } else {
+        lat_record(LAT_PLAIN, lat_since(record->event.time));
+    }
+}
+
+static void lat_dump(void) {
+    static const char *const names[LAT_KINDS] = {"plain", "hold-tap", "combo", "deferred"};
+    uint32_t events = 0;
+
+    for (uint8_t i = 0; i < LAT_KINDS; i++) {
+        lat_stat_t *stat = &lat_stats[i];
+        events += stat->count;
+        if (stat->count) {
+            uprintf("lat %-8s n=%lu min=%u avg=%lu max=%u ms\n", names[i], stat->count, stat->min, stat->sum / stat->count, stat->max);
+        }
+    }
+    uprintf("lat events=%lu keyboard reports=%lu mouse reports=%lu\n", events, lat_keyboard_reports, lat_mouse_reports);
+    combo_index_dump();
+#if MY_UNICODE_ENABLE
+    unicode_queue_dump();
+#endif
+    key_override_index_dump();
+    layer_cache_dump();
+#if MY_TRACKPOINT_ENABLE
+    uprintf("ps2 resyncs=%u errors=%u recoveries=%u\n", ps2_mouse_resync_count(), ps2_mouse_error_count(), ps2_mouse_recovery_count());
+    trackpoint_dump();
+    if (ps2_mouse_is_ready()) {
+        uprintf("boot: keys after %lu ms, trackpoint after %lu ms\n", lat_keys_ready, ps2_mouse_ready_time());
+    } else {
+        uprintf("boot: keys after %lu ms, trackpoint not ready\n", lat_keys_ready);
+    }
+#endif
+
+    memset(lat_stats, 0, sizeof(lat_stats));
+    lat_keyboard_reports = 0;
+    lat_mouse_reports = 0;
+}
+
+static void lat_matrix_scan(void) {
+    static matrix_row_t previous[MATRIX_ROWS];
+    static bool         scanned = false;
+
+    if (!scanned) {
+        scanned = true;
+        lat_keys_ready = timer_read32();
+    }
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t current = matrix_get_row(row);
+        if (current & ~previous[row]) {
+            lat_last_press = timer_read();
+        }
+        previous[row] = current;
+    }
+}
+
+#endif
+
+#if MY_LATENCY_STATS_ENABLE || MY_PROFILE_ENABLE || MY_TELEMETRY_ENABLE
+// Every HID report goes through the host driver: wrap it to count and time them.
+// The driver is set after keyboard_post_init_user, so this is done lazily from housekeeping.
+static host_driver_t *lat_host_driver = NULL;
+static host_driver_t lat_counting_driver;
+
+static void lat_send_keyboard(report_keyboard_t *report) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_keyboard_reports++;
+#endif
+#if MY_TELEMETRY_ENABLE
+    telemetry_report(false);
+#endif
+    scan_profile_exclude_begin();
+    lat_host_driver->send_keyboard(report);
+    scan_profile_exclude_end(PROF_USB);
+}
+
+static void lat_send_mouse(report_mouse_t *report) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_mouse_reports++;
+#endif
+#if MY_TELEMETRY_ENABLE
+    telemetry_report(true);
+#endif
+    scan_profile_exclude_begin();
+    lat_host_driver->send_mouse(report);
+    scan_profile_exclude_end(PROF_USB);
+}
+
+static void lat_wrap_host_driver(void) {
+    host_driver_t *driver = host_get_driver();
+    if (driver == NULL || driver == &lat_counting_driver) return;
+
+    lat_host_driver = driver;
+    lat_counting_driver = *driver;
+    lat_counting_driver.send_keyboard = lat_send_keyboard;
+    lat_counting_driver.send_mouse = lat_send_mouse;
+    host_set_driver(&lat_counting_driver);
+}
+#endif
+
+
+
+//    %-----------------%
+//    | MAIN LOOP HOOKS |
+//    %-----------------%
+
+void keyboard_post_init_user(void) {
+    combo_index_init();
+    key_override_index_init();
+#if MY_GAME_PROFILE_ENABLE
+    game_profile_init(ADD_LAYER);
+#endif
+}
+
+#if MY_GAME_PROFILE_ENABLE
+static void game_profile_switch(void) {
+    if (game_profile_task() && !game_profile_active()) { // the index scans were skipped in the game
+        combo_index_resync();
+        key_override_index_resync();
+    }
+}
+#endif
+
+// With MY_PROFILE_ENABLE, each scan_profile_mark() closes the phase it names: see scan_profile.h
+void matrix_scan_user(void) { // runs after debounce, before the key events are processed
+    scan_profile_mark(PROF_MATRIX);
+    bool typing = true;
+#if MY_GAME_PROFILE_ENABLE
+    typing = !game_profile_active(); // combos and key overrides are off in the game
+#endif
+    if (typing) {
+        combo_index_scan();
+        scan_profile_mark(PROF_COMBO);
+        key_override_index_scan();
+        scan_profile_mark(PROF_OVERRIDE);
+    }
+#if MY_LATENCY_STATS_ENABLE
+    lat_matrix_scan();
+#endif
+}
+
+void housekeeping_task_user(void) {
+    scan_profile_mark(PROF_OTHER);
+#if MY_GAME_PROFILE_ENABLE
+    game_profile_switch();
+#endif
+    combo_index_task();
+    scan_profile_mark(PROF_COMBO);
+#if MY_UNICODE_ENABLE
+    unicode_queue_task();
+#endif
+#if MY_TELEMETRY_ENABLE
+    telemetry_task();
+#endif
+#if MY_LATENCY_STATS_ENABLE || MY_PROFILE_ENABLE || MY_TELEMETRY_ENABLE
+    lat_wrap_host_driver();
+#endif
+    scan_profile_loop();
+}
+
+#if MY_TELEMETRY_ENABLE
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    telemetry_receive(data, length);
+}
+#endif
+
+#if MY_PROFILE_ENABLE
+void post_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    scan_profile_mark(PROF_OVERRIDE);
+}
+
+#    if MY_TRACKPOINT_ENABLE
+report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
+    scan_profile_mark(PROF_POINTING);
+    return mouse_report;
+}
+#    endif
+#endif
+
+
+
 //    %---------------------%
 //    |  NEW KEY BEHAVIOUR  |
 //    %---------------------%
 
-// Per-key tapping term for cluster keys
+// Per-key tapping term, longer in fast bursts and shorter in slow editing: see tapping_term.c
+static tapping_term_key_t tapping_terms[] = {
+    TAPPING_TERM_KEY(ESC_ALT, 120, 200, true),
+    TAPPING_TERM_KEY(LEFT_TOGGLE, 120, 200, true),
+    TAPPING_TERM_KEY(RIGHT_TOGGLE, 120, 200, true),
+    TAPPING_TERM_KEY(TWO_TOGGLE, 120, 200, true),
+    TAPPING_TERM_KEY(HOME_LCTL, 100, 160, true), // faster tapping term for cluster keys
+    TAPPING_TERM_KEY(END_SHIFT, 100, 160, false), // types capitals mid-burst
+};
+
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
-    switch (keycode) {
-        case HOME_LCTL:
-        case END_SHIFT:
-            return 100;  // Faster tapping term for cluster keys
-        default:
-            return TAPPING_TERM;
+#if MY_GAME_PROFILE_ENABLE
+    if (game_profile_active() && IS_QK_MOD_TAP(keycode)) {
+        return 0; // a hold at once, the tap comes from retro tapping
     }
+#endif
+    return tapping_term_get(tapping_terms, ARRAY_SIZE(tapping_terms), keycode);
+}
+
+#if MY_GAME_PROFILE_ENABLE
+bool get_retro_tapping(uint16_t keycode, keyrecord_t *record) {
+    return game_profile_active() && IS_QK_MOD_TAP(keycode);
+}
+#endif
+
+bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
+    return tapping_term_hold_on_other_key_press(tapping_terms, ARRAY_SIZE(tapping_terms), keycode);
 }
 
-// for cap lock
-static deferred_token my_token = INVALID_DEFERRED_TOKEN;
-uint32_t kc_end_callback(uint32_t trigger_time, void *cb_arg) {
+// every matrix event, before combos and tap-hold buffer it
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    scan_profile_mark(PROF_ACTION); // process_combo and the tap-hold resolution run next
+#if MY_GAME_PROFILE_ENABLE
+    game_profile_switch(); // a layer toggle of the previous event may have left the game
+#endif
+    tapping_term_record(tapping_terms, ARRAY_SIZE(tapping_terms), keycode, record);
+#if MY_TRACE_ENABLE
+    key_trace_edge(keycode, record);
+#endif
+    return true;
+}
+
+// Home and End on one tap, scroll layer and caps word on two: see double_tap.c
+static void end_single(uint16_t time) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_record(LAT_DEFERRED, timer_elapsed(time));
+#endif
+#if MY_UNICODE_ENABLE
+    unicode_queue_flush(); // the glyphs queued before this tap reach the host first
+#endif
     tap_code(KC_END);
-    return false;
 }
-static deferred_token my_token1 = INVALID_DEFERRED_TOKEN;
-uint32_t kc_home_callback(uint32_t trigger_time, void *cb_arg) {
+
+static void end_double(uint16_t time) {
+    caps_word_on();
+}
+
+static void home_single(uint16_t time) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_record(LAT_DEFERRED, timer_elapsed(time));
+#endif
+#if MY_UNICODE_ENABLE
+    unicode_queue_flush(); // the glyphs queued before this tap reach the host first
+#endif
     tap_code(KC_HOME);
-    return false;
 }
 
+static void home_double(uint16_t time) {
+    static bool toggle_scroll_layer = false;
+    if (!toggle_scroll_layer){
+        layer_on(SCROLL_LAYER);
+    } else {
+        layer_off(SCROLL_LAYER);
+    }
+    toggle_scroll_layer = !toggle_scroll_layer;
+}
+
+static double_tap_t double_taps[] = {
+    DOUBLE_TAP(END_SHIFT, end_single, end_double),
+    DOUBLE_TAP(HOME_LCTL, home_single, home_double),
+};
+
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    return double_tap_quick_tap_term(double_taps, ARRAY_SIZE(double_taps), keycode, record);
+}
+
+static bool process_record_keymap(uint16_t keycode, keyrecord_t *record);
+
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    scan_profile_mark(PROF_RESOLVE);
+    bool handled = process_record_keymap(keycode, record);
+    scan_profile_mark(PROF_USER);
+    return handled;
+}
+
+static bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_process_record(keycode, record);
+#endif
+
+#if MY_TELEMETRY_ENABLE
+    telemetry_record(record);
+#endif
+
+#if MY_TRACE_ENABLE
+    key_trace_resolve(keycode, record);
+#endif
+
+#if MY_TRACKPOINT_ENABLE
+    if (record->event.pressed && layer_state_is(MOUSE_LAYER)) {
+        ps2_mouse_poll_now(); // the stick is in use: no remote mode poll backoff
+    }
+#endif
+
+#if MY_UNICODE_ENABLE
+    bool                  glyph    = false;
+    const key_override_t *override = NULL;
+    if (record->event.pressed) {
+        override = key_override_index_firing(keycode);
+        glyph    = override ? override->custom_action == send_unicode : IS_QK_UNICODEMAP(keycode) || IS_QK_UNICODEMAP_PAIR(keycode);
+        if (!glyph) {
+            unicode_queue_flush(); // the queued glyphs come first, also before a Home or End this press fires
+        }
+    }
+#endif
+
+    if (!double_tap_process(double_taps, ARRAY_SIZE(double_taps), keycode, record)) {
+        return false; // a tap of HOME_LCTL or END_SHIFT, the press of any other key fired a pending one first
+    }
+
+#if MY_UNICODE_ENABLE
+    if (glyph && !override && (IS_QK_UNICODEMAP(keycode) || IS_QK_UNICODEMAP_PAIR(keycode))) {
+        unicode_queue_push(unicode_index(keycode)); // join the burst instead of typing it alone, unless an override replaces it
+        return false;
+    }
+#endif
+
     switch (keycode) {
 
         case RIGHT_TOGGLE:
@@ -961,62 +1257,108 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 
         ///// ---------------------
 
-        case END_SHIFT: // toggle caps word
+        case ACCEL: // toggle between different cursor and wheel speeds
 
-            if (record->event.pressed && record->tap.count) {
-                if (record->tap.count == 1) {
-                    my_token = defer_exec(100, kc_end_callback, NULL);
+            if (record->event.pressed) {
+                static bool accel = true;
+                if (accel) {
+                    mousekey_on(MS_ACL0);
                 } else {
-                    cancel_deferred_exec(my_token);
-                    caps_word_on();
+                    mousekey_on(MS_ACL1);
                 }
-                return false;
+                accel = !accel;
             }
-
             break;
 
         ///// ---------------------
 
-            case HOME_LCTL: // toggle scroll layer
-
-                static bool toggle_scroll_layer = false;
-                if (record->event.pressed && record->tap.count) {
-                    if (record->tap.count == 1) {
-                        my_token1 = defer_exec(100, kc_home_callback, NULL);
-                    } else {
-                        cancel_deferred_exec(my_token1);
-                        if (!toggle_scroll_layer){
-                            layer_on(SCROLL_LAYER);
-                        } else {
-                            layer_off(SCROLL_LAYER);
-                        }
-                        toggle_scroll_layer = !toggle_scroll_layer;
-                    }
-                    return false;
-                }
+#if MY_TRACKPOINT_ENABLE
+        case TP_DOWN: // step the trackpoint registers without reflashing
+        case TP_UP:
 
-                break;
+            if (record->event.pressed) {
+                uint8_t addr = (get_mods() & MOD_MASK_SHIFT) ? TP_REG_SPEED : TP_REG_SENSITIVITY;
+                trackpoint_adjust(addr, keycode == TP_UP ? TRACKPOINT_ADJUST_STEP : -TRACKPOINT_ADJUST_STEP);
+            }
+            return false;
+            break;
 
         ///// ---------------------
+#endif
 
-        case ACCEL: // toggle between different cursor and wheel speeds
+#if MY_LATENCY_STATS_ENABLE || MY_PROFILE_ENABLE || MY_TRACE_ENABLE
+        case LAT_DUMP: // print and reset the latency statistics and the scan profile, shifted: print the key trace
 
             if (record->event.pressed) {
-                static bool accel = true;
-                if (accel) {
-                    mousekey_on(MS_ACL0);
-                } else {
-                    mousekey_on(MS_ACL1);
+#if MY_TRACE_ENABLE
+                if (get_mods() & MOD_MASK_SHIFT) {
+                    key_trace_dump();
+                    return false;
                 }
-                accel = !accel;
+#endif
+#if MY_LATENCY_STATS_ENABLE
+                lat_dump();
+                uprintf("double tap windows: end=%u home=%u ms\n", double_tap_window(&double_taps[0], NULL), double_tap_window(&double_taps[1], NULL));
+                uprintf("typing: %u ms between presses\n", tapping_term_interval());
+#endif
+                scan_profile_dump();
             }
+            return false;
             break;
+#endif
     }
     return true;
 }
 
 
 
+//    %--------------------%
+//    |   OVERLAY LAYERS   |
+//    %--------------------%
+
+// Transparent layers with a few keys, as K(position, keycode) in matrix order: POS_xxx in overlay_layer.h
+// Keymap readers see them at their layer number through keycode_at_keymap_location, the other layers move down in keymaps[]
+
+#if MY_TRACKPOINT_ENABLE
+// mouse transparent layer: the buttons on U I O (left, middle, right)
+#define MOUSE_OVERLAY(K) \
+    K(POS_R03, MS_BTN2) K(POS_R02, MS_BTN3) K(POS_R01, MS_BTN1)
+
+OVERLAY_LAYER(mouse_overlay, MOUSE_OVERLAY);
+#endif
+
+// scroll transparent layer: back and forward on E R, the buttons on U I O, ACCEL on J, the wheel on the arrows
+#define SCROLL_OVERLAY(K) \
+    K(POS_L02, MS_BTN4) K(POS_L03, MS_BTN5) \
+    K(POS_R03, MS_BTN2) K(POS_R02, MS_BTN3) K(POS_R01, MS_BTN1) \
+    K(POS_R12, MS_WHLU) K(POS_R11, ACCEL) \
+    K(POS_R23, MS_WHLR) K(POS_R22, MS_WHLD) K(POS_R21, MS_WHLL)
+
+OVERLAY_LAYER(scroll_overlay, SCROLL_OVERLAY);
+
+static const overlay_layer_t *const overlay_layers[OVERLAY_LAYERS] = {
+#if MY_TRACKPOINT_ENABLE
+    &mouse_overlay,
+#endif
+    &scroll_overlay,
+};
+
+uint8_t keymap_layer_count(void) {
+    return keymap_layer_count_raw() + OVERLAY_LAYERS;
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t col) {
+    if (layer < FIRST_OVERLAY) {
+        return keycode_at_keymap_location_raw(layer, row, col);
+    }
+    if (layer < ADD_LAYER) {
+        return overlay_layer_keycode(overlay_layers[layer - FIRST_OVERLAY], row, col);
+    }
+    return keycode_at_keymap_location_raw(DENSE_LAYER(layer), row, col);
+}
+
+
+
 //    %---------------------%
 //    |   KEYBOARD LAYERS   |
 //    %---------------------%
@@ -1050,11 +1392,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 
     [2] = LAYOUT_split_3x6_3( //stuff
     //,-----------------------------------------------------.                    ,-----------------------------------------------------.
-         KC_F1,   KC_F2,   KC_F3,   KC_F4,   KC_F5,  KC_PWR,                      UG_TOGG,KC_PSCR,XXXXXXX,XXXXXXX,TG(ADD_LAYER+1),TG(ADD_LAYER),
+         KC_F1,   KC_F2,   KC_F3,   KC_F4,   KC_F5,  KC_PWR,                      UG_TOGG,KC_PSCR,MY_TP_DOWN,MY_TP_UP,TG(ADD_LAYER+1),TG(ADD_LAYER),
     //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
         KC_F6,    KC_F7,   KC_F8,   KC_F9,  KC_F10,  KC_BSPC,                TG_GREEK_LAYER, ACCEL,  KC_UP,  KC_BRIU,  KC_VOLU, KC_MUTE,
     //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
-        KC_F11,   KC_F12, XXXXXXX, XXXXXXX, KC_SPC, KC_ENTER,            	      KC_CALC, KC_LEFT, KC_DOWN, KC_RIGHT, KC_MPLY, EE_CLR,
+        KC_F11,   KC_F12, MY_LAT_DUMP, XXXXXXX, KC_SPC, KC_ENTER,            	      KC_CALC, KC_LEFT, KC_DOWN, KC_RIGHT, KC_MPLY, EE_CLR,
     //|--------+--------+--------+--------+--------+--------+--------|  |--------+--------+--------+--------+--------+--------+--------|
                                         KC_LGUI,LEFT_TOGGLE,HOME_LCTL,	 END_SHIFT,RIGHT_TOGGLE,ESC_ALT
                                         //`--------------------------'  `--------------------------'
@@ -1074,33 +1416,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   ),
   #endif
 
-  #if MY_TRACKPOINT_ENABLE
-    [MOUSE_LAYER] = LAYOUT_split_3x6_3( // mouse transparent layer
-      //,-----------------------------------------------------.                    ,-----------------------------------------------------.
-         KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,                      KC_TRNS, MS_BTN1, MS_BTN3, MS_BTN2, KC_TRNS, KC_TRNS,
-      //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
-         KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,                      KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,
-      //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
-         KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,                      KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,
-      //|--------+--------+--------+--------+--------+--------+--------|  |--------+--------+--------+--------+--------+--------+--------|
-                                             KC_TRNS, KC_TRNS, KC_TRNS,    KC_TRNS, KC_TRNS, KC_TRNS
-                                          //`--------------------------'  `--------------------------'
-  ),
-  #endif
-
-
-
-  [SCROLL_LAYER] = LAYOUT_split_3x6_3( // scroll transparent layer
-    //,-----------------------------------------------------.                    ,-----------------------------------------------------.
-       KC_TRNS, KC_TRNS, MS_BTN4, MS_BTN5, KC_TRNS, KC_TRNS,                      KC_TRNS, MS_BTN1, MS_BTN3, MS_BTN2, KC_TRNS, KC_TRNS,
-    //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
-       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,                      KC_TRNS,  ACCEL, MS_WHLU,  KC_TRNS, KC_TRNS, KC_TRNS,
-    //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
-       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,                      KC_TRNS, MS_WHLL, MS_WHLD, MS_WHLR, KC_TRNS, KC_TRNS,
-    //|--------+--------+--------+--------+--------+--------+--------|  |--------+--------+--------+--------+--------+--------+--------|
-                                           KC_TRNS, KC_TRNS,  KC_TRNS,    KC_TRNS, KC_TRNS, KC_TRNS
-                                        //`--------------------------'  `--------------------------'
-  ),
+  // MOUSE_LAYER and SCROLL_LAYER are the overlays above, out of this array
 
 
 
@@ -1108,7 +1424,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 
 
 
-    [ADD_LAYER] = LAYOUT_split_3x6_3( //vr_chat
+    [DENSE_LAYER(ADD_LAYER)] = LAYOUT_split_3x6_3( //vr_chat
       //,-----------------------------------------------------.                    ,-----------------------------------------------------.
           KC_F12,  XXXXXXX,  KC_E,    KC_W,    KC_R,    KC_C,                     S(KC_F1), S(KC_F2), S(KC_F3), S(KC_F4), S(KC_F5), S(KC_F6),
       //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
@@ -1120,7 +1436,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
                                           //`--------------------------'  `--------------------------'
   ),
 
-    [ADD_LAYER+1] = LAYOUT_split_3x6_3( //minecraft
+    [DENSE_LAYER(ADD_LAYER+1)] = LAYOUT_split_3x6_3( //minecraft
       //,-----------------------------------------------------.                    ,-----------------------------------------------------.
            KC_M,    KC_B,    KC_E,    KC_W,   KC_F5,   KC_F1,                         KC_1,   KC_2,     KC_3,    KC_4,    KC_5,    KC_6,
       //|--------+--------+--------+--------+--------+--------|                    |--------+--------+--------+--------+--------+--------|
@@ -0,0 +1,92 @@
+/*
+This is the c file of the layer cache
+
+To find the keycode of a key QMK walks the active layers from the top down (layer_switch_get_layer),
+reading the keymap of each one until a key is not KC_TRNS. Up to eight layers can be stacked here,
+and the mouse and scroll layers on top are almost all KC_TRNS, so a base key is read several times per event,
+and again by the combo and key override code.
+This overrides QMK's weak keymap_key_to_keycode with a cache of the resolved layer and keycode of each key:
+a layer above the resolved one answers KC_TRNS and the resolved one its keycode, both from RAM.
+The cache is checked against layer_state | default_layer_state at every lookup and emptied when they changed,
+so it also follows the plain layer_state assignments of the layer toggles, which skip layer_state_set.
+Each key is then resolved again at its first lookup: a typing run on one layer reads the keymap once per key.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "layer_cache.h"
+
+typedef struct {
+    uint16_t keycode;
+    uint8_t  layer; // highest active layer where the key is not KC_TRNS, 0 if none
+} layer_cache_entry_t;
+
+static layer_cache_entry_t cache[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t        valid[MATRIX_ROWS];
+static layer_state_t       cached_state = 0;
+
+#if MY_LATENCY_STATS_ENABLE
+static uint32_t cache_lookups = 0;
+static uint32_t cache_reads = 0; // keymap reads, one per lookup without the cache
+static uint32_t cache_flushes = 0;
+
+#    define CACHE_COUNT(counter) ((counter)++)
+#else
+// compiled out: the lookups on every key event count nothing
+#    define CACHE_COUNT(counter)
+#endif
+
+
+static void resolve(layer_cache_entry_t *entry, layer_state_t state, uint8_t row, uint8_t col) {
+    for (int8_t layer = MAX_LAYER - 1; layer > 0; layer--) {
+        if (!(state & ((layer_state_t)1 << layer))) continue;
+
+        CACHE_COUNT(cache_reads);
+        uint16_t keycode = keycode_at_keymap_location(layer, row, col);
+        if (keycode != KC_TRNS) {
+            entry->keycode = keycode;
+            entry->layer   = layer;
+            return;
+        }
+    }
+    CACHE_COUNT(cache_reads);
+    entry->keycode = keycode_at_keymap_location(0, row, col); // as QMK: the base layer when all above are KC_TRNS
+    entry->layer   = 0;
+}
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) return KC_NO; // combo and other virtual keys
+
+    layer_state_t state = layer_state | default_layer_state;
+    if (state != cached_state) {
+        cached_state = state;
+        memset(valid, 0, sizeof(valid));
+        CACHE_COUNT(cache_flushes);
+    }
+
+    CACHE_COUNT(cache_lookups);
+    layer_cache_entry_t *entry = &cache[key.row][key.col];
+    matrix_row_t         mask  = (matrix_row_t)1 << key.col;
+    if (!(valid[key.row] & mask)) {
+        resolve(entry, state, key.row, key.col);
+        valid[key.row] |= mask;
+    }
+
+    if (layer == entry->layer) return entry->keycode;
+    if (layer > entry->layer && state & ((layer_state_t)1 << layer)) return KC_TRNS; // walked past it
+    CACHE_COUNT(cache_reads);
+    return keycode_at_keymap_location(layer, key.row, key.col); // a layer that is not on the walk
+}
+
+#if MY_LATENCY_STATS_ENABLE
+void layer_cache_dump(void) {
+    // without the cache every lookup is a keymap read
+    uprintf("layer cache: lookups=%lu keymap reads=%lu flushes=%lu\n", cache_lookups, cache_reads, cache_flushes);
+    cache_lookups = 0;
+    cache_reads = 0;
+    cache_flushes = 0;
+}
+#endif
@@ -0,0 +1,13 @@
+/*
+This is the header of the layer cache: it keeps the keycode each key resolves to through the active layers
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#if MY_LATENCY_STATS_ENABLE
+void layer_cache_dump(void); // console report of the lookups served from the cache
+#endif
@@ -0,0 +1,28 @@
+/*
+This is the c file of the overlay layers
+
+The mouse and scroll layers sit on top of the others and only define a few keys: as dense layers of keymaps[]
+they cost MATRIX_ROWS * MATRIX_COLS keycodes each, almost all KC_TRNS.
+An overlay layer keeps a bitmap of the positions it defines and their keycodes packed in matrix order:
+a key is KC_TRNS when its bit is clear, else its keycode is the one after as many others as there are bits below it.
+The keymap writes each overlay as a list of positions and keycodes, the bitmap and the keycode table are built from it
+by the preprocessor, and its keycode_at_keymap_location reads the overlay layers here.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "overlay_layer.h"
+
+_Static_assert(MATRIX_ROWS * MATRIX_COLS <= 64, "the overlay bitmap holds 64 positions");
+
+
+uint16_t overlay_layer_keycode(const overlay_layer_t *layer, uint8_t row, uint8_t col) {
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) return KC_TRNS;
+
+    uint64_t bit = (uint64_t)1 << (row * MATRIX_COLS + col);
+    if (!(layer->keys & bit)) return KC_TRNS;
+    return pgm_read_word(&layer->keycodes[__builtin_popcountll(layer->keys & (bit - 1))]);
+}
@@ -0,0 +1,82 @@
+/*
+This is the header of the overlay layers: sparse layers that are KC_TRNS but for a few keys
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t        keys;     // bit row * MATRIX_COLS + col for each key that is not KC_TRNS
+    const uint16_t *keycodes; // PROGMEM, one per bit, in matrix order
+} overlay_layer_t;
+
+// positions of LAYOUT_split_3x6_3 as "row, col" of the matrix: L/R half, layout row, column from the left
+// the right half is wired mirrored, and the thumbs sit on the last three columns of the fourth row
+#define POS_L00 0, 0
+#define POS_L01 0, 1
+#define POS_L02 0, 2
+#define POS_L03 0, 3
+#define POS_L04 0, 4
+#define POS_L05 0, 5
+#define POS_L10 1, 0
+#define POS_L11 1, 1
+#define POS_L12 1, 2
+#define POS_L13 1, 3
+#define POS_L14 1, 4
+#define POS_L15 1, 5
+#define POS_L20 2, 0
+#define POS_L21 2, 1
+#define POS_L22 2, 2
+#define POS_L23 2, 3
+#define POS_L24 2, 4
+#define POS_L25 2, 5
+#define POS_L30 3, 3
+#define POS_L31 3, 4
+#define POS_L32 3, 5
+#define POS_R00 4, 5
+#define POS_R01 4, 4
+#define POS_R02 4, 3
+#define POS_R03 4, 2
+#define POS_R04 4, 1
+#define POS_R05 4, 0
+#define POS_R10 5, 5
+#define POS_R11 5, 4
+#define POS_R12 5, 3
+#define POS_R13 5, 2
+#define POS_R14 5, 1
+#define POS_R15 5, 0
+#define POS_R20 6, 5
+#define POS_R21 6, 4
+#define POS_R22 6, 3
+#define POS_R23 6, 2
+#define POS_R24 6, 1
+#define POS_R25 6, 0
+#define POS_R30 7, 5
+#define POS_R31 7, 4
+#define POS_R32 7, 3
+
+// callbacks for a list LIST(K) of K(POS_xxx, keycode) entries, written in matrix order (row, then col)
+#define OVERLAY_BIT(pos, keycode) OVERLAY_BIT_(pos)
+#define OVERLAY_BIT_(row, col) | ((uint64_t)1 << OVERLAY_INDEX_(row, col))
+#define OVERLAY_INDEX_(row, col) ((row) * MATRIX_COLS + (col))
+#define OVERLAY_KEYCODE(pos, keycode) keycode,
+
+// ((-1 < a ? a : 64) < b ? b : 64) ...: the last position while each one is above the previous, else 64
+#define OVERLAY_OPEN(pos, keycode) (
+#define OVERLAY_NEXT(pos, keycode) OVERLAY_NEXT_(pos)
+#define OVERLAY_NEXT_(row, col) < OVERLAY_INDEX_(row, col) ? OVERLAY_INDEX_(row, col) : 64)
+#define OVERLAY_ASCENDING(LIST) ((LIST(OVERLAY_OPEN) - 1 LIST(OVERLAY_NEXT)) < 64)
+
+// the keycodes and the bitmap of an overlay from its list, checked for positions listed twice or out of order:
+// the lookup finds a keycode by counting the bits below its position
+#define OVERLAY_LAYER(name, LIST)                                                                            \
+    static const uint16_t name##_keycodes[] PROGMEM = {LIST(OVERLAY_KEYCODE)};                               \
+    _Static_assert(OVERLAY_ASCENDING(LIST), #name ": positions are not listed in matrix order, each once");  \
+    static const overlay_layer_t name = {.keys = 0 LIST(OVERLAY_BIT), .keycodes = name##_keycodes}
+
+uint16_t overlay_layer_keycode(const overlay_layer_t *layer, uint8_t row, uint8_t col); // KC_TRNS where the overlay has no key
@@ -16,12 +16,23 @@ MOUSEKEY_ENABLE = yes
 EXTRAKEY_ENABLE = yes
 DEFERRED_EXEC_ENABLE = yes
 
+SRC += combo_index.c
+SRC += key_override_index.c
+SRC += double_tap.c
+SRC += tapping_term.c
+SRC += layer_cache.c
+SRC += overlay_layer.c
+
+DEBOUNCE_TYPE = custom
+SRC += custom_debounce.c
+
 
 MY_TRACKPOINT_ENABLE = yes
 ifeq ($(MY_TRACKPOINT_ENABLE),yes)
    POINTING_DEVICE_ENABLE = yes
    POINTING_DEVICE_DRIVER = ps2_mouse
    PS2_DRIVER = vendor
+   SRC += trackpoint.c
    OPT_DEFS += -DMY_TRACKPOINT_ENABLE #define it in C files
 endif
 
@@ -29,6 +40,45 @@ endif
 MY_UNICODE_ENABLE = yes
 ifeq ($(MY_UNICODE_ENABLE),yes)
    OS_DETECTION_ENABLE = yes
-   UNICODEMAP_ENABLE = yes
+   UNICODE_ENABLE = yes
+   SRC += unicode_queue.c
    OPT_DEFS += -DMY_UNICODE_ENABLE #define it in C files
 endif
+
+
+MY_GAME_PROFILE_ENABLE = yes
+ifeq ($(MY_GAME_PROFILE_ENABLE),yes)
+   SRC += game_profile.c
+   OPT_DEFS += -DMY_GAME_PROFILE_ENABLE #define it in C files
+endif
+
+
+MY_LATENCY_STATS_ENABLE = no
+ifeq ($(MY_LATENCY_STATS_ENABLE),yes)
+   CONSOLE_ENABLE = yes
+   OPT_DEFS += -DMY_LATENCY_STATS_ENABLE #define it in C files
+endif
+
+
+MY_PROFILE_ENABLE = no
+ifeq ($(MY_PROFILE_ENABLE),yes)
+   CONSOLE_ENABLE = yes
+   SRC += scan_profile.c
+   OPT_DEFS += -DMY_PROFILE_ENABLE #define it in C files
+endif
+
+
+MY_TELEMETRY_ENABLE = no
+ifeq ($(MY_TELEMETRY_ENABLE),yes)
+   RAW_ENABLE = yes
+   SRC += telemetry.c
+   OPT_DEFS += -DMY_TELEMETRY_ENABLE #define it in C files
+endif
+
+
+MY_TRACE_ENABLE = no
+ifeq ($(MY_TRACE_ENABLE),yes)
+   CONSOLE_ENABLE = yes
+   SRC += key_trace.c
+   OPT_DEFS += -DMY_TRACE_ENABLE #define it in C files
+endif
@@ -0,0 +1,126 @@
+/*
+This is the c file of the scan profiler
+
+The keymap and custom_debounce.c mark the end of each phase of the main loop from the hooks they implement,
+and the time since the previous mark goes to that phase.
+At the end of each iteration, the time of every phase that ran is recorded:
+count, min, sum and max, plus a histogram with power of two buckets (1, 2-3, 4-7, ... 1024+ us).
+On the RP2040 the time is read from the 1 MHz hardware timer; elsewhere the millisecond timer is used.
+Everything is compiled out unless MY_PROFILE_ENABLE is set in rules.mk.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "scan_profile.h"
+
+#define SCAN_PROFILE_BUCKETS 11
+
+typedef struct {
+    uint32_t count; // iterations the phase ran in
+    uint64_t sum;   // 32 bits would wrap after 71 minutes of loops
+    uint32_t min;
+    uint32_t max;
+    uint32_t buckets[SCAN_PROFILE_BUCKETS];
+} scan_profile_stat_t;
+
+static scan_profile_stat_t stats[PROF_PHASES];
+static uint32_t            spent[PROF_PHASES]; // in the current iteration
+static uint32_t            last_mark = 0;
+static uint32_t            loop_start = 0;
+static uint32_t            exclude_start = 0;
+static bool                running = false; // the first iteration starts at the first loop end
+
+static uint32_t window_sum[PROF_PHASES]; // since the last scan_profile_window()
+static uint32_t window_loops = 0;
+static uint32_t window_loop_max = 0;
+
+
+static inline uint32_t now_us(void) {
+#if defined(MCU_RP)
+    return TIMER->TIMERAWL;
+#else
+    return timer_read32() * 1000;
+#endif
+}
+
+void scan_profile_mark(uint8_t phase) {
+    uint32_t now = now_us();
+    spent[phase] += now - last_mark;
+    last_mark = now;
+}
+
+void scan_profile_exclude_begin(void) {
+    exclude_start = now_us();
+}
+
+void scan_profile_exclude_end(uint8_t phase) {
+    uint32_t nested = now_us() - exclude_start;
+    spent[phase] += nested;
+    last_mark += nested; // the phase around it resumes where it was
+}
+
+static void record(scan_profile_stat_t *stat, uint32_t us) {
+    uint8_t bucket = 0;
+    while ((us >> (bucket + 1)) && bucket < SCAN_PROFILE_BUCKETS - 1) {
+        bucket++;
+    }
+
+    if (!stat->count || us < stat->min) stat->min = us;
+    if (us > stat->max) stat->max = us;
+    stat->sum += us;
+    stat->count++;
+    stat->buckets[bucket]++;
+}
+
+void scan_profile_loop(void) {
+    scan_profile_mark(PROF_OTHER);
+    if (running) {
+        spent[PROF_LOOP] = last_mark - loop_start;
+        for (uint8_t i = 0; i < PROF_PHASES; i++) {
+            if (spent[i]) record(&stats[i], spent[i]);
+            window_sum[i] += spent[i];
+        }
+        window_loops++;
+        if (spent[PROF_LOOP] > window_loop_max) window_loop_max = spent[PROF_LOOP];
+    }
+    running    = true;
+    loop_start = last_mark;
+    memset(spent, 0, sizeof(spent));
+}
+
+void scan_profile_dump(void) {
+    static const char *const names[PROF_PHASES] = {"matrix", "debounce", "action", "resolve", "combo", "override", "user", "pointing", "usb", "other", "loop"};
+    uint64_t                 loop_sum = stats[PROF_LOOP].sum;
+
+    uprintf("prof phase    n min avg max us, share of the loop, histogram 1 2 4 ... 1024+ us\n");
+    for (uint8_t i = 0; i < PROF_PHASES; i++) {
+        scan_profile_stat_t *stat = &stats[i];
+        if (!stat->count) continue;
+
+        uint32_t share = loop_sum ? (uint32_t)(stat->sum * 1000 / loop_sum) : 0;
+        uprintf("prof %-8s n=%lu %lu/%lu/%lu us %lu.%lu%% |", names[i], stat->count, stat->min, (uint32_t)(stat->sum / stat->count), stat->max, share / 10, share % 10);
+        for (uint8_t b = 0; b < SCAN_PROFILE_BUCKETS; b++) {
+            uprintf(" %lu", stat->buckets[b]);
+        }
+        uprintf("\n");
+    }
+    if (loop_sum) {
+        uprintf("prof scan rate %lu Hz\n", (uint32_t)((uint64_t)stats[PROF_LOOP].count * 1000000 / loop_sum));
+    }
+    memset(stats, 0, sizeof(stats));
+}
+
+void scan_profile_window(uint16_t avg_us[PROF_PHASES], uint16_t *loop_max_us) {
+    for (uint8_t i = 0; i < PROF_PHASES; i++) {
+        uint32_t avg = window_loops ? window_sum[i] / window_loops : 0;
+        avg_us[i]    = avg > UINT16_MAX ? UINT16_MAX : avg;
+    }
+    *loop_max_us = window_loop_max > UINT16_MAX ? UINT16_MAX : window_loop_max;
+
+    memset(window_sum, 0, sizeof(window_sum));
+    window_loops    = 0;
+    window_loop_max = 0;
+}
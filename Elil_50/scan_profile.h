@@ -0,0 +1,43 @@
+/*
+This is the header of the scan profiler: it times each phase of the main loop in microseconds
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+// each phase ends at a hook of the keymap, see the marks in keymap.c and custom_debounce.c
+enum scan_profile_phase {
+    PROF_MATRIX,   // matrix read up to debounce(), and the split transport after it up to matrix_scan_user
+    PROF_DEBOUNCE, // debounce()
+    PROF_ACTION,   // layer lookup of the event, up to pre_process_record_user
+    PROF_RESOLVE,  // process_combo, then tap-hold resolution, up to process_record_user: QMK runs no hook between the two
+    PROF_COMBO,    // combo index
+    PROF_OVERRIDE, // key override index, and what runs after process_record_user: key overrides and the action
+    PROF_USER,     // process_record_user
+    PROF_POINTING, // from the last key event to pointing_device_task_user: quantum tasks and the pointing device read
+    PROF_USB,      // reports handed to the host driver
+    PROF_OTHER,    // the rest of the loop, up to the end of housekeeping_task_user
+    PROF_LOOP,     // one whole iteration of the main loop
+    PROF_PHASES
+};
+
+#if MY_PROFILE_ENABLE
+void scan_profile_mark(uint8_t phase);                                       // the time since the previous mark went to phase
+void scan_profile_exclude_begin(void);                                       // start of a nested phase, e.g. a report sent from inside another phase
+void scan_profile_exclude_end(uint8_t phase);                                // the nested time goes to phase, not to the one around it
+void scan_profile_loop(void);                                                // call at the end of housekeeping_task_user, closes the iteration
+void scan_profile_dump(void);                                                // console report of the phases since the last dump
+void scan_profile_window(uint16_t avg_us[PROF_PHASES], uint16_t *loop_max_us); // averages per loop since the last call, for the telemetry
+#else
+// compiled out: the marks cost nothing
+#    define scan_profile_mark(phase)
+#    define scan_profile_exclude_begin()
+#    define scan_profile_exclude_end(phase)
+#    define scan_profile_loop()
+#    define scan_profile_dump()
+#endif
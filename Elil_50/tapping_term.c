@@ -0,0 +1,95 @@
+/*
+This is the c file of the adaptive tapping term
+
+A fixed tapping term is a compromise: in a fast burst a hold-tap key is meant as a tap and needs a long term,
+while in slow editing it is meant as a modifier or layer and a long term only makes the hold sluggish.
+Here the matrix edges of the last TAPPING_TERM_INTERVALS presses give the mean time between presses,
+counted from the last pause only so that a burst is seen after two or three presses,
+and each listed key gets its term from it, interpolated between its bounds:
+max at TAPPING_TERM_FAST and faster, min at TAPPING_TERM_SLOW and slower.
+A pause of TAPPING_TERM_IDLE starts the typing over as slow, so the first modifier after it holds quickly.
+The term of a key is taken when it is pressed and kept while it is held,
+as QMK asks for it again on every event until the key is resolved.
+A roll_tap key pressed in a burst also has HOLD_ON_OTHER_KEY_PRESS turned off, leaving PERMISSIVE_HOLD:
+rolling into the next letter would otherwise make it hold.
+A shift that types capitals mid-burst is often released before its letter, and needs it on.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "tapping_term.h"
+
+_Static_assert((TAPPING_TERM_INTERVALS & (TAPPING_TERM_INTERVALS - 1)) == 0, "TAPPING_TERM_INTERVALS must be a power of two");
+_Static_assert(TAPPING_TERM_FAST < TAPPING_TERM_SLOW, "TAPPING_TERM_FAST must be under TAPPING_TERM_SLOW");
+
+static uint16_t intervals[TAPPING_TERM_INTERVALS];
+static uint16_t interval_sum = 0;
+static uint8_t  interval_count = 0; // since the last pause, up to TAPPING_TERM_INTERVALS
+static uint8_t  next = 0;
+static uint16_t last_press = 0;
+
+
+static void push(uint16_t interval) {
+    if (interval_count < TAPPING_TERM_INTERVALS) {
+        interval_count++;
+    } else {
+        interval_sum -= intervals[next];
+    }
+    interval_sum += interval;
+    intervals[next] = interval;
+    next = (next + 1) & (TAPPING_TERM_INTERVALS - 1);
+}
+
+uint16_t tapping_term_interval(void) {
+    return interval_count ? interval_sum / interval_count : TAPPING_TERM_SLOW;
+}
+
+bool tapping_term_burst(void) {
+    return tapping_term_interval() <= TAPPING_TERM_FAST;
+}
+
+static uint16_t adapt(tapping_term_key_t *key) {
+    uint16_t mean = tapping_term_interval();
+
+    if (mean <= TAPPING_TERM_FAST) return key->max;
+    if (mean >= TAPPING_TERM_SLOW) return key->min;
+    return key->max - (uint32_t)(key->max - key->min) * (mean - TAPPING_TERM_FAST) / (TAPPING_TERM_SLOW - TAPPING_TERM_FAST);
+}
+
+void tapping_term_record(tapping_term_key_t *keys, uint8_t count, uint16_t keycode, keyrecord_t *record) {
+    if (record->event.type != KEY_EVENT || !record->event.pressed) return;
+
+    uint16_t interval = record->event.time - last_press;
+    bool     first    = last_press == 0; // nothing to measure from yet
+    last_press        = record->event.time | 1; // never 0, one ms off at most
+    if (first || interval >= TAPPING_TERM_IDLE) {
+        interval_sum   = 0; // the typing starts over, as slow until the next press
+        interval_count = 0;
+    } else {
+        push(interval < TAPPING_TERM_SLOW ? interval : TAPPING_TERM_SLOW);
+    }
+
+    for (tapping_term_key_t *key = keys; key < keys + count; key++) {
+        if (key->keycode == keycode) {
+            key->term  = adapt(key); // the interval of this very press counts: after a pause it is a hold
+            key->burst = tapping_term_burst();
+        }
+    }
+}
+
+uint16_t tapping_term_get(tapping_term_key_t *keys, uint8_t count, uint16_t keycode) {
+    for (tapping_term_key_t *key = keys; key < keys + count; key++) {
+        if (key->keycode == keycode) return key->term;
+    }
+    return TAPPING_TERM;
+}
+
+bool tapping_term_hold_on_other_key_press(tapping_term_key_t *keys, uint8_t count, uint16_t keycode) {
+    for (tapping_term_key_t *key = keys; key < keys + count; key++) {
+        if (key->keycode == keycode) return !(key->roll_tap && key->burst);
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+/*
+This is the header of the adaptive tapping term: it follows the typing speed with the tapping term of the hold-tap keys
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+
+// presses the typing speed is averaged over, a power of two
+#ifndef TAPPING_TERM_INTERVALS
+#    define TAPPING_TERM_INTERVALS 8
+#endif
+
+// mean ms between presses at which the keys get their longest term: a burst, where they are meant as taps
+#ifndef TAPPING_TERM_FAST
+#    define TAPPING_TERM_FAST 150
+#endif
+
+// mean ms between presses at which the keys get their shortest term: slow editing, where they are meant as holds
+#ifndef TAPPING_TERM_SLOW
+#    define TAPPING_TERM_SLOW 400
+#endif
+
+// a pause this long starts the typing over as slow
+#ifndef TAPPING_TERM_IDLE
+#    define TAPPING_TERM_IDLE 1000
+#endif
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t min;      // term at TAPPING_TERM_SLOW and slower
+    uint16_t max;      // term at TAPPING_TERM_FAST and faster
+    bool     roll_tap; // in a burst, rolling into the next key is a tap: not for a shift that types capitals
+    uint16_t term;     // taken at the last press of the key, kept until the next one
+    bool     burst;    // the last press of the key came in a burst
+} tapping_term_key_t;
+
+#define TAPPING_TERM_KEY(kc, term_min, term_max, rolls) \
+    { .keycode = (kc), .min = (term_min), .max = (term_max), .roll_tap = (rolls), .term = (term_min) }
+
+void     tapping_term_record(tapping_term_key_t *keys, uint8_t count, uint16_t keycode, keyrecord_t *record); // call from pre_process_record_user with every event
+uint16_t tapping_term_get(tapping_term_key_t *keys, uint8_t count, uint16_t keycode);                        // for get_tapping_term, TAPPING_TERM for the other keys
+bool     tapping_term_hold_on_other_key_press(tapping_term_key_t *keys, uint8_t count, uint16_t keycode);    // for get_hold_on_other_key_press, false for a roll_tap key in a burst
+bool     tapping_term_burst(void);                                                                            // typing at TAPPING_TERM_FAST or faster
+uint16_t tapping_term_interval(void);                                                                         // mean ms between the last presses
@@ -0,0 +1,183 @@
+/*
+This is the c file of the raw HID telemetry
+
+The console (pd_dprintf, uprintf) formats text on the keyboard and is far too slow to leave on while typing.
+Here the counters are sent as fixed binary frames on the raw HID interface instead:
+- a host reader (telemetry_reader.py) sends TELEMETRY_START with a window length, and renews it while it reads;
+- at the end of each window the keyboard sends one counters frame, and one phases frame with MY_PROFILE_ENABLE;
+- streaming stops on TELEMETRY_STOP, or TELEMETRY_LEASE ms after the last command.
+The counts are deltas over the window, so a dropped frame only loses its own window.
+With MY_TRACE_ENABLE, TELEMETRY_TRACE sends the key trace, one frame per loop while recording is paused.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "telemetry.h"
+
+#if MY_TRACKPOINT_ENABLE
+#    include "drivers/sensors/ps2_mouse.h"
+#endif
+
+static bool     streaming = false;
+static uint16_t interval = 1000;
+static uint16_t last_command = 0;
+static uint16_t window_start = 0;
+static uint8_t  sequence = 0;
+
+static telemetry_counters_t window; // counts of the current window
+
+#if MY_TRACE_ENABLE
+static bool     trace_sending = false;
+static uint16_t trace_next = 0; // next event of the trace to send
+static uint8_t  trace_frame = 0;
+#endif
+
+#if MY_TRACKPOINT_ENABLE
+static uint16_t ps2_last[4]; // driver totals at the start of the window
+
+static void take_ps2(void);
+#endif
+
+
+void telemetry_receive(uint8_t *data, uint8_t length) {
+    if (length < 4 || data[0] != TELEMETRY_MAGIC) return;
+
+    switch (data[1]) {
+        case TELEMETRY_START:
+            interval = data[2] | data[3] << 8;
+            if (interval < TELEMETRY_INTERVAL_MIN) interval = TELEMETRY_INTERVAL_MIN;
+            if (!streaming) {
+                streaming = true;
+                window_start = timer_read();
+#if MY_TRACKPOINT_ENABLE
+                take_ps2(); // the first window starts from the current totals
+#endif
+#if MY_PROFILE_ENABLE
+                uint16_t avg_us[PROF_PHASES], loop_max_us;
+                scan_profile_window(avg_us, &loop_max_us); // discard what ran before
+#endif
+                memset(&window, 0, sizeof(window));
+            }
+            last_command = timer_read();
+            break;
+        case TELEMETRY_STOP:
+            streaming = false;
+            break;
+#if MY_TRACE_ENABLE
+        case TELEMETRY_TRACE:
+            if (!trace_sending) {
+                key_trace_pause(true); // the ring must not move under the reader
+                trace_sending = true;
+                trace_next    = 0;
+                trace_frame   = 0;
+            }
+            break;
+#endif
+    }
+}
+
+void telemetry_record(keyrecord_t *record) {
+    if (!record->event.pressed) return;
+
+    if (record->event.type == COMBO_EVENT) {
+        window.combo_hits++;
+    } else {
+        window.key_presses++;
+    }
+}
+
+void telemetry_override(void) {
+    window.override_hits++;
+}
+
+void telemetry_report(bool mouse) {
+    if (mouse) {
+        window.mouse_reports++;
+    } else {
+        window.keyboard_reports++;
+    }
+}
+
+static void send_frame(void *frame, uint8_t type, uint8_t number, uint16_t length) {
+    telemetry_header_t *header = frame;
+
+    header->magic       = TELEMETRY_MAGIC;
+    header->version     = TELEMETRY_VERSION;
+    header->type        = type;
+    header->sequence    = number;
+    header->interval_ms = length;
+    raw_hid_send(frame, 32);
+}
+
+#if MY_TRACKPOINT_ENABLE
+// delta of a driver total since the last window
+static uint16_t ps2_delta(uint8_t i, uint16_t total) {
+    uint16_t delta = total - ps2_last[i];
+    ps2_last[i]    = total;
+    return delta;
+}
+
+static void take_ps2(void) {
+    window.ps2_packets    = ps2_delta(0, ps2_mouse_packet_count());
+    window.ps2_errors     = ps2_delta(1, ps2_mouse_error_count());
+    window.ps2_resyncs    = ps2_delta(2, ps2_mouse_resync_count());
+    window.ps2_recoveries = ps2_delta(3, ps2_mouse_recovery_count());
+}
+#endif
+
+#if MY_TRACE_ENABLE
+static void send_trace(void) {
+    telemetry_trace_t frame = {0};
+    key_trace_event_t event;
+
+    while (frame.count < 3 && key_trace_get(trace_next, &event)) {
+        memcpy(&frame.events[frame.count++], &event, sizeof(event));
+        trace_next++;
+    }
+    send_frame(&frame, TELEMETRY_TRACE_EVENTS, trace_frame++, key_trace_count());
+
+    if (!frame.count) { // the empty frame ends the trace
+        trace_sending = false;
+        key_trace_pause(false);
+    }
+}
+#endif
+
+void telemetry_task(void) {
+#if MY_TRACE_ENABLE
+    if (trace_sending) {
+        send_trace();
+        return;
+    }
+#endif
+    if (!streaming) return;
+
+    if (window.scans < UINT16_MAX) window.scans++;
+    if (timer_elapsed(last_command) >= TELEMETRY_LEASE) {
+        streaming = false; // the reader went away
+        return;
+    }
+    uint16_t length = timer_elapsed(window_start);
+    if (length < interval) return;
+    window_start = timer_read();
+
+#if MY_TRACKPOINT_ENABLE
+    take_ps2();
+#endif
+    send_frame(&window, TELEMETRY_COUNTERS, sequence, length);
+    memset(&window, 0, sizeof(window));
+
+#if MY_PROFILE_ENABLE
+    telemetry_phases_t phases = {0};
+    uint16_t           avg_us[PROF_PHASES], loop_max_us; // the packed fields cannot be passed by pointer
+    scan_profile_window(avg_us, &loop_max_us);
+    memcpy(phases.avg_us, avg_us, sizeof(avg_us));
+    phases.loop_max_us = loop_max_us;
+    send_frame(&phases, TELEMETRY_PHASES, sequence, length);
+#endif
+    sequence++;
+}
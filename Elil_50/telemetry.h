@@ -0,0 +1,91 @@
+/*
+This is the header of the raw HID telemetry: it streams the keyboard counters to a host reader
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+#include "scan_profile.h"
+#include "key_trace.h"
+
+// Protocol, all frames RAW_EPSIZE (32) bytes, little endian, decoded by telemetry_reader.py:
+// host -> keyboard: magic, command, interval ms (uint16), the rest is ignored
+// keyboard -> host: telemetry_header_t, then the body of its frame type
+#define TELEMETRY_MAGIC 0xE7
+#define TELEMETRY_VERSION 3
+
+// streaming stops this long after the last command, so a reader that went away does not keep the endpoint busy
+#ifndef TELEMETRY_LEASE
+#    define TELEMETRY_LEASE 5000
+#endif
+
+#ifndef TELEMETRY_INTERVAL_MIN
+#    define TELEMETRY_INTERVAL_MIN 100
+#endif
+
+enum telemetry_command {
+    TELEMETRY_STOP,
+    TELEMETRY_START, // stream one window every interval ms, also renews the lease
+    TELEMETRY_TRACE, // send the key trace once, only with MY_TRACE_ENABLE
+};
+
+enum telemetry_frame_type {
+    TELEMETRY_COUNTERS = 1,
+    TELEMETRY_PHASES, // only with MY_PROFILE_ENABLE
+    TELEMETRY_TRACE_EVENTS,
+};
+
+typedef struct __attribute__((packed)) {
+    uint8_t  magic;
+    uint8_t  version;
+    uint8_t  type;
+    uint8_t  sequence;    // one per window, the frames of a window share it
+    uint16_t interval_ms; // length of the window
+} telemetry_header_t;
+
+// counts over the window
+typedef struct __attribute__((packed)) {
+    telemetry_header_t header;
+    uint16_t           scans; // main loop iterations
+    uint16_t           key_presses;
+    uint16_t           combo_hits;
+    uint16_t           override_hits;
+    uint16_t           keyboard_reports;
+    uint16_t           mouse_reports;
+    uint16_t           ps2_packets;
+    uint16_t           ps2_errors;
+    uint16_t           ps2_resyncs;
+    uint16_t           ps2_recoveries;
+    uint16_t           reserved[3];
+} telemetry_counters_t;
+
+// main loop phases of scan_profile.h over the window
+typedef struct __attribute__((packed)) {
+    telemetry_header_t header;
+    uint16_t           avg_us[PROF_PHASES]; // per loop iteration, in the order of enum scan_profile_phase
+    uint16_t           loop_max_us;
+    uint8_t            reserved[32 - sizeof(telemetry_header_t) - 2 * (PROF_PHASES + 1)];
+} telemetry_phases_t;
+
+// a slice of the key trace of key_trace.h, oldest first: the header sequence counts the frames
+// and interval_ms holds the events of the whole trace
+typedef struct __attribute__((packed)) {
+    telemetry_header_t header;
+    uint8_t            count; // events in this frame, 0 ends the trace
+    uint8_t            reserved;
+    key_trace_event_t  events[3];
+} telemetry_trace_t;
+
+_Static_assert(sizeof(telemetry_counters_t) == 32 && sizeof(telemetry_phases_t) == 32 && sizeof(telemetry_trace_t) == 32, "telemetry frames must be RAW_EPSIZE bytes");
+
+void telemetry_receive(uint8_t *data, uint8_t length);     // call from raw_hid_receive
+void telemetry_record(keyrecord_t *record);                // call from process_record_user with every event
+void telemetry_override(void);                             // call from the custom_action of every key override when it activates
+void telemetry_report(bool mouse);                         // a report was handed to the host driver
+void telemetry_task(void);                                 // call from housekeeping_task_user, sends the frames of an ended window
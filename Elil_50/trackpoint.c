@@ -0,0 +1,127 @@
+/*
+This is the c file of the trackpoint registers
+
+The trackpoint settings live in its RAM, and they are lost whenever it resets.
+They used to be hand-unrolled 0xE2 0x81 <addr> <value> sends, whose failures were silently ignored.
+Here they are a table of registers instead:
+- each register is read first through 0xE2 0x80 <addr>, and is not written again if it already holds its value;
+- a written register is read back, and written again on a mismatch, up to TRACKPOINT_RETRIES times;
+- the table is kept, so the adjust keys can step one of its values at runtime and a reconnect can replay it;
+- it is applied one register per pointing device task, from the init of the PS/2 driver, so the keys are never
+  held up by the whole table.
+The commands go out with the data reporting off, so no motion byte can be taken for an answer.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "drivers/sensors/ps2_mouse.h"
+#include "ps2.h"
+#include "trackpoint.h"
+
+#define TP_COMMAND 0xE2
+#define TP_READ_MEM 0x80
+#define TP_WRITE_MEM 0x81
+
+static trackpoint_register_t *registers = NULL; // table of the last apply, for the adjust keys
+static uint8_t                register_count = 0;
+static uint8_t                register_next  = 0; // next register trackpoint_apply_step() sets
+
+static uint16_t reads    = 0;
+static uint16_t writes   = 0;
+static uint16_t skipped  = 0; // registers that already held their value
+static uint16_t retries  = 0;
+static uint16_t failures = 0;
+
+
+// every byte of a command is acknowledged on its own
+static bool trackpoint_send(uint8_t data) {
+    return ps2_host_send(data) == PS2_ACK && ps2_error == PS2_ERR_NONE;
+}
+
+bool trackpoint_read(uint8_t addr, uint8_t *value) {
+    reads++;
+    if (!trackpoint_send(TP_COMMAND) || !trackpoint_send(TP_READ_MEM) || !trackpoint_send(addr)) {
+        return false;
+    }
+    *value = ps2_host_recv_response();
+    return ps2_error == PS2_ERR_NONE;
+}
+
+bool trackpoint_write(uint8_t addr, uint8_t value) {
+    writes++;
+    return trackpoint_send(TP_COMMAND) && trackpoint_send(TP_WRITE_MEM) && trackpoint_send(addr) && trackpoint_send(value);
+}
+
+bool trackpoint_set(uint8_t addr, uint8_t value) {
+    uint8_t current;
+
+    if (trackpoint_read(addr, &current) && current == value) {
+        skipped++;
+        return true;
+    }
+    for (uint8_t i = 0; i < TRACKPOINT_RETRIES; i++) {
+        if (i) retries++;
+        if (trackpoint_write(addr, value) && trackpoint_read(addr, &current) && current == value) {
+            return true;
+        }
+    }
+    failures++;
+    pd_dprintf("trackpoint: register 0x%02X did not take 0x%02X\n", addr, value);
+    return false;
+}
+
+// in stream mode the trackpoint sends motion whenever it likes: keep it quiet while the commands go out
+static void trackpoint_quiet(bool quiet) {
+#ifndef PS2_MOUSE_USE_REMOTE_MODE
+    if (quiet) {
+        ps2_mouse_disable_data_reporting();
+    } else {
+        ps2_mouse_enable_data_reporting();
+    }
+#endif
+}
+
+void trackpoint_apply(trackpoint_register_t *table, uint8_t count) {
+    registers      = table;
+    register_count = count;
+    register_next  = 0;
+}
+
+bool trackpoint_apply_step(void) {
+    if (register_next == register_count) {
+        register_next = 0; // the next init of the driver replays the table
+        return true;
+    }
+    trackpoint_set(registers[register_next].addr, registers[register_next].value); // a failure is counted and printed there
+    register_next++;
+    return false;
+}
+
+bool trackpoint_adjust(uint8_t addr, int8_t delta) {
+    if (!ps2_mouse_is_ready()) {
+        return false; // the init owns the wire, and replays the table once the trackpoint answers
+    }
+    for (uint8_t i = 0; i < register_count; i++) {
+        if (registers[i].addr != addr) continue;
+
+        int16_t value = registers[i].value + delta;
+        registers[i].value = value < 0 ? 0 : value > 0xFF ? 0xFF : value;
+
+        trackpoint_quiet(true);
+        bool ok = trackpoint_set(addr, registers[i].value);
+        trackpoint_quiet(false);
+        return ok;
+    }
+    return false; // not in the table: there is nothing to replay it from
+}
+
+void trackpoint_dump(void) {
+    uprintf("trackpoint reads=%u writes=%u skipped=%u retries=%u failures=%u\n", reads, writes, skipped, retries, failures);
+    for (uint8_t i = 0; i < register_count; i++) {
+        uprintf("trackpoint 0x%02X=0x%02X\n", registers[i].addr, registers[i].value);
+    }
+    reads = writes = skipped = retries = failures = 0;
+}
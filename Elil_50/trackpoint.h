@@ -0,0 +1,43 @@
+/*
+This is the header of the trackpoint registers: it writes a table of RAM registers and reads each one back
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// RAM locations, see the TrackPoint System Version 4.0 Engineering Specification
+#define TP_REG_PTS_TOGGLE 0x2C // bit 0 enables press to select
+#define TP_REG_SENSITIVITY 0x4A
+#define TP_REG_NEG_INERTIA 0x4D
+#define TP_REG_PTS_THRESHOLD 0x5C
+#define TP_REG_SPEED 0x60
+
+// writes tried on a register that does not read back what was written
+#ifndef TRACKPOINT_RETRIES
+#    define TRACKPOINT_RETRIES 3
+#endif
+
+// change of an adjust key press
+#ifndef TRACKPOINT_ADJUST_STEP
+#    define TRACKPOINT_ADJUST_STEP 0x10
+#endif
+
+typedef struct {
+    uint8_t addr;
+    uint8_t value;
+} trackpoint_register_t;
+
+// the register calls expect the data reporting to be off in stream mode, as in ps2_mouse_configure_user(); adjust turns it off itself
+bool trackpoint_read(uint8_t addr, uint8_t *value);                 // 0xE2 0x80 addr, the trackpoint answers with the value
+bool trackpoint_write(uint8_t addr, uint8_t value);                 // 0xE2 0x81 addr value, not verified
+bool trackpoint_set(uint8_t addr, uint8_t value);                   // write only if it differs, then read it back, retrying on a mismatch
+void trackpoint_apply(trackpoint_register_t *table, uint8_t count); // keep a RAM table for the steps below and the adjust keys
+bool trackpoint_apply_step(void);                                   // set the next register of the table, true once none is left
+bool trackpoint_adjust(uint8_t addr, int8_t delta);                 // step a register of the kept table, saturated to 0 - 255
+void trackpoint_dump(void);                                         // console report of the register traffic
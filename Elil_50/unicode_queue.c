@@ -0,0 +1,125 @@
+/*
+This is the c file of the unicode queue
+
+Typing a glyph used to release the user mods, type the unicode sequence and restore the mods:
+the release is a HID report whenever a mod is held (restoring them with set_mods() sends none).
+Here glyphs are queued instead, and a burst is typed with the mods released once:
+- the burst is closed UNICODE_BURST_TERM ms after its last glyph, at the end of the scan that queued it by default;
+- process_record_user closes it before any other key press, so the host gets everything in order.
+A glyph thus reaches the host up to UNICODE_BURST_TERM ms late, but never after the next key.
+Each glyph is typed from unicode_hid[], the keycodes of its hex digits built by the compiler from the symbol lists,
+instead of formatting the codepoint nibble by nibble on every keystroke. It is the only table of the glyphs:
+the input modes that need the codepoint read it back from the digits.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include QMK_KEYBOARD_H
+#include "unicode_queue.h"
+
+static uint8_t  queue[UNICODE_QUEUE_SIZE]; // unicode_name indices
+static uint8_t  queue_len = 0;
+static uint16_t last_push = 0;
+
+static uint32_t glyphs[UNICODE_MODE_COUNT];
+static uint32_t sessions[UNICODE_MODE_COUNT];
+
+
+void unicode_queue_push(uint8_t name) {
+    queue[queue_len++] = name;
+    last_push = timer_read();
+    if (queue_len == UNICODE_QUEUE_SIZE) {
+        unicode_queue_flush();
+    }
+}
+
+uint8_t unicode_index(uint16_t keycode) {
+    if (IS_QK_UNICODEMAP_PAIR(keycode)) {
+        bool shift = (get_mods() | get_oneshot_mods()) & MOD_MASK_SHIFT;
+        bool caps  = host_keyboard_led_state().caps_lock;
+        return (shift ^ caps) ? QK_UNICODEMAP_PAIR_GET_SHIFTED_INDEX(keycode) : QK_UNICODEMAP_PAIR_GET_UNSHIFTED_INDEX(keycode);
+    }
+    return QK_UNICODEMAP_GET_INDEX(keycode);
+}
+
+// the codepoint of a unicode_name, for the input modes without a unicode_hid[] sequence
+static uint16_t unicode_codepoint(uint8_t name) {
+    const unicode_hid_t *hid  = &unicode_hid[name];
+    uint16_t             code = 0;
+    for (uint8_t i = 0; i < sizeof(hid->keys); i++) {
+        uint8_t key = pgm_read_byte(&hid->keys[i]);
+        code        = code << 4 | (key == KC_0 ? 0 : key >= KC_1 ? 1 + key - KC_1 : 10 + key - KC_A);
+    }
+    return code;
+}
+
+// same sequence as register_unicode(), without formatting the codepoint
+static void type_glyph(uint8_t name) {
+    uint8_t mode = get_unicode_input_mode();
+    if (mode != UNICODE_MODE_LINUX && mode != UNICODE_MODE_MACOS && mode != UNICODE_MODE_WINCOMPOSE) {
+        register_unicode(unicode_codepoint(name));
+        return;
+    }
+
+    const unicode_hid_t *hid   = &unicode_hid[name];
+    uint8_t              first = pgm_read_byte(&hid->keys[0]);
+
+    unicode_input_start();
+    if (mode == UNICODE_MODE_WINCOMPOSE && first >= KC_A && first <= KC_F) {
+        tap_code(KC_0); // WinCompose reads a sequence starting with a letter as a name
+    }
+    for (uint8_t i = 0; i < sizeof(hid->keys); i++) {
+        tap_code(pgm_read_byte(&hid->keys[i]));
+    }
+    unicode_input_finish();
+}
+
+void unicode_queue_flush(void) {
+    if (!queue_len) return;
+
+    uint8_t saved_mods = get_mods();
+    unregister_mods(saved_mods); // temporarily clear user mods: we don't suppress them in MAKE_OVERRIDE
+
+    for (uint8_t i = 0; i < queue_len; i++) {
+        type_glyph(queue[i]);
+    }
+
+    set_mods(saved_mods); // restore mods
+
+    uint8_t mode = get_unicode_input_mode();
+    if (mode < UNICODE_MODE_COUNT) {
+        glyphs[mode] += queue_len;
+        sessions[mode]++;
+    }
+    queue_len = 0;
+}
+
+void unicode_queue_task(void) {
+    if (queue_len && timer_elapsed(last_push) >= UNICODE_BURST_TERM) {
+        unicode_queue_flush();
+    }
+}
+
+void unicode_queue_dump(void) {
+    static const struct {
+        uint8_t     mode;
+        const char *name;
+    } modes[] = {
+        {UNICODE_MODE_LINUX, "linux"},
+        {UNICODE_MODE_MACOS, "macos"},
+        {UNICODE_MODE_WINCOMPOSE, "wincompose"},
+    };
+
+    // the reports a session saves depend on the mods held: the host harness counts them, with the queue and without
+    for (uint8_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        uint8_t mode = modes[i].mode;
+        if (!glyphs[mode]) continue;
+
+        uprintf("unicode %-10s glyphs=%lu sessions=%lu (%lu.%02lu glyphs per session)\n", modes[i].name, glyphs[mode], sessions[mode],
+                glyphs[mode] / sessions[mode], (glyphs[mode] * 100 / sessions[mode]) % 100);
+    }
+    memset(glyphs, 0, sizeof(glyphs));
+    memset(sessions, 0, sizeof(sessions));
+}
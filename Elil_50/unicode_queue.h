@@ -0,0 +1,41 @@
+/*
+This is the header of the unicode queue: it types back-to-back glyphs in one mod-suppressed session
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ms a burst stays open for the next glyph: the last glyph of a burst reaches the host that late,
+// unless another key is pressed first. 0 closes it at the end of the scan, with the glyphs of that scan
+#ifndef UNICODE_BURST_TERM
+#    define UNICODE_BURST_TERM 0
+#endif
+
+// glyphs a burst holds before it is typed: 1 types each glyph as it comes, as without the queue
+#ifndef UNICODE_QUEUE_SIZE
+#    define UNICODE_QUEUE_SIZE 16
+#endif
+
+// keycodes of the 4 hex digits register_hex32() types for a BMP codepoint
+typedef struct {
+    uint8_t keys[4];
+} unicode_hid_t;
+
+extern const unicode_hid_t unicode_hid[]; // one entry per unicode_name, in flash, defined with the symbols in keymap.c
+
+#define UNICODE_HEX_KC(digit) ((digit) == 0 ? KC_0 : (digit) < 10 ? KC_1 + (digit) - 1 : KC_A + (digit) - 10)
+#define UNICODE_DIGIT_KC(cp, i) UNICODE_HEX_KC(((cp) >> (4 * (3 - (i)))) & 0xF)
+#define UNICODE_HID(cp) {{UNICODE_DIGIT_KC(cp, 0), UNICODE_DIGIT_KC(cp, 1), UNICODE_DIGIT_KC(cp, 2), UNICODE_DIGIT_KC(cp, 3)}}
+
+uint8_t unicode_index(uint16_t keycode); // unicode_name typed by a UM() or UP() keycode
+
+void unicode_queue_push(uint8_t name);       // queue a unicode_name on the current burst
+void unicode_queue_flush(void);              // type the queued glyphs, before any other key reaches the host
+void unicode_queue_task(void);               // call from housekeeping_task_user, closes the expired burst
+void unicode_queue_dump(void);               // console report of the glyphs and of the sessions they were typed in
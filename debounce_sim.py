@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+# Runs the debounce of Elil_50/custom_debounce.c against generated switch bounce, next to QMK's default sym_defer_g
+# usage: ./debounce_sim.py [--scan-us us] [--presses N] [--seed N] [--trace FILE]
+# --trace takes the press and release times from a replay file of ./telemetry_reader.py --trace
+#
+# custom_debounce.c itself runs, built with the DEBOUNCE of config.h by make -C host debounce.so:
+# host/debounce_host.c gives it the simulated ms clock and the game profile.
+#
+# Each edge of a key bounces: the contacts toggle a few times at random within the bounce time of the profile,
+# and settle in the new state at its end. The matrix is read every scan, with the ms clock of timer_read().
+# For each algorithm it counts chatter (registered edges that the finger did not make) and missed edges,
+# and the latency from the first contact of each edge to its registration.
+# It fails when custom_debounce.c chatters or misses under a profile that bounces for DEBOUNCE ms at most.
+
+import argparse
+import ctypes
+import math
+import os
+import random
+import subprocess
+import sys
+
+from telemetry_reader import load_trace
+
+HOST = os.path.join(os.path.dirname(os.path.abspath(__file__)), "host")
+
+PROFILES = (  # name, longest bounce as a share of DEBOUNCE, toggles at most
+    ("clean", 0.0, 0),
+    ("typical", 0.5, 4),
+    ("worn", 1.0, 8),
+    ("failing", 2.0, 12),  # beyond DEBOUNCE: every algorithm may chatter, shown for scale
+)
+
+
+def bounce(rng, start, longest, toggles):
+    # the times the contacts toggle for an edge at start, the first one being the edge itself
+    if not toggles or longest <= 0:
+        return [start]
+    length = rng.uniform(0, longest)
+    inner = sorted(rng.uniform(start, start + length) for _ in range(2 * rng.randint(0, toggles // 2)))
+    return [start] + inner
+
+
+def typing(rng, presses, keys):
+    # (time_ms, key, pressed) of a typist at about 8 keys a second with some overlap
+    events, time_ms, free = [], 50.0, {}
+    for _ in range(presses):
+        time_ms += rng.uniform(40, 200)
+        key = rng.choice([k for k in range(keys) if free.get(k, 0) < time_ms - 20])
+        hold = rng.uniform(30, 150)
+        events += [(time_ms, key, True), (time_ms + hold, key, False)]
+        free[key] = time_ms + hold
+    return sorted(events)
+
+
+def from_trace(path, cols):
+    events = [(e["time"], e["row"] * cols + e["col"], e["pressed"]) for e in load_trace(path) if not e["combo"]]
+    return sorted(events)
+
+
+class DeferGlobal:
+    # quantum/debounce/sym_defer_g.c, QMK's default
+    def __init__(self, debounce):
+        self.debounce, self.debouncing, self.time = debounce, False, 0
+
+    def __call__(self, now, raw, cooked, changed):
+        if changed:
+            self.debouncing, self.time = True, now
+        if self.debouncing and (now - self.time) & 0xFFFF >= self.debounce:
+            self.debouncing = False
+            cooked[:] = raw
+
+    def idle(self):
+        return not self.debouncing
+
+
+def load_custom():
+    # host/debounce.so, rebuilt if custom_debounce.c or config.h changed
+    subprocess.run(["make", "-s", "-C", HOST, "debounce.so"], check=True)
+    lib = ctypes.CDLL(os.path.join(HOST, "debounce.so"))
+    lib.debounce_host_init.argtypes = [ctypes.c_bool]
+    lib.debounce_host_scan.argtypes = [ctypes.c_uint16, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_bool]
+    lib.debounce_host_scan.restype = ctypes.c_bool
+    lib.debounce_host_idle.restype = ctypes.c_bool
+    return lib
+
+
+class CustomDebounce:
+    # debounce() of Elil_50/custom_debounce.c, eager = the game profile; key = row * MATRIX_COLS + col
+    def __init__(self, lib, eager=False):
+        self.lib = lib
+        self.rows = ctypes.c_uint8.in_dll(lib, "debounce_host_rows").value
+        self.cols = ctypes.c_uint8.in_dll(lib, "debounce_host_cols").value
+        self.raw = (ctypes.c_uint8 * self.rows)()
+        self.cooked = (ctypes.c_uint8 * self.rows)()
+        lib.debounce_host_init(eager)
+
+    def __call__(self, now, raw, cooked, changed):
+        if changed:
+            for row in range(self.rows):
+                self.raw[row] = sum(1 << col for col in range(self.cols) if raw[row * self.cols + col])
+        if self.lib.debounce_host_scan(now, self.raw, self.cooked, changed):
+            for key in range(len(cooked)):
+                cooked[key] = bool(self.cooked[key // self.cols] >> key % self.cols & 1)
+
+    def idle(self):
+        return self.lib.debounce_host_idle()
+
+
+def run(algorithm, keys, edges, scan_us, end):
+    # edges: (time_ms, key, state, edge index) of every contact toggle, sorted
+    raw, cooked = [False] * keys, [False] * keys
+    seen, next_edge, registered = [None] * keys, 0, []
+    scan, step = 0.0, scan_us / 1000
+    while scan < end:
+        if algorithm.idle() and next_edge < len(edges) and edges[next_edge][0] > scan + step:
+            scan = math.floor(edges[next_edge][0] / step) * step  # nothing to do until the next toggle
+        changed = False
+        while next_edge < len(edges) and edges[next_edge][0] <= scan:
+            _, key, state, index = edges[next_edge]
+            changed |= raw[key] != state
+            raw[key], seen[key] = state, index
+            next_edge += 1
+        before = list(cooked)
+        algorithm(int(scan) & 0xFFFF, raw, cooked, changed)
+        for key in range(keys):
+            if cooked[key] != before[key]:
+                registered.append((scan, key, cooked[key], seen[key]))
+        scan += step
+    return registered
+
+
+def score(strokes, registered):
+    # strokes: (time_ms, key, pressed) the finger made; registered: (time, key, pressed, edge index)
+    latency = {True: [], False: []}
+    chatter, done = 0, set()
+    for time_ms, key, pressed, index in registered:
+        stroke = strokes[index]
+        if index in done or stroke[2] != pressed:
+            chatter += 1
+            continue
+        done.add(index)
+        latency[pressed].append(time_ms - stroke[0])
+    return chatter, len(strokes) - len(done), latency
+
+
+def stats(values):
+    if not values:
+        return "-"
+    values = sorted(values)
+    return "%.2f/%.2f/%.2f" % (sum(values) / len(values), values[int(len(values) * 0.95)], values[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate the debounce against generated switch bounce")
+    parser.add_argument("--scan-us", type=float, default=200, help="time between matrix scans in us (default 200)")
+    parser.add_argument("--presses", type=int, default=2000, help="presses per profile (default 2000)")
+    parser.add_argument("--keys", type=int, default=48, help="matrix positions (default 48, the 8x6 matrix)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--trace", metavar="FILE", help="replay file to take the typing from")
+    args = parser.parse_args()
+
+    lib = load_custom()
+    debounce = ctypes.c_uint8.in_dll(lib, "debounce_host_ms").value
+    matrix = ctypes.c_uint8.in_dll(lib, "debounce_host_rows").value * ctypes.c_uint8.in_dll(lib, "debounce_host_cols").value
+    rng = random.Random(args.seed)
+    strokes = from_trace(args.trace, 6) if args.trace else typing(rng, args.presses, args.keys)
+    keys = max(args.keys, max(key for _, key, _ in strokes) + 1)
+    if keys > matrix:
+        sys.exit("the matrix has %d positions, not %d" % (matrix, keys))
+    algorithms = (("sym_defer_g", lambda: DeferGlobal(debounce)),
+                  ("custom", lambda: CustomDebounce(lib)),
+                  ("custom game", lambda: CustomDebounce(lib, eager=True)))
+
+    print("DEBOUNCE %d ms, scan every %g us, %d edges; latency in ms mean/p95/max from the first contact"
+          % (debounce, args.scan_us, len(strokes)))
+    print("%-8s %-12s %7s %6s %18s %18s" % ("profile", "algorithm", "chatter", "missed", "press", "release"))
+    failed = False
+    for profile, share, toggles in PROFILES:
+        edges = []
+        for index, (time_ms, key, pressed) in enumerate(strokes):
+            for n, toggle in enumerate(bounce(rng, time_ms, share * debounce, toggles)):
+                edges.append((toggle, key, pressed == (n % 2 == 0), index))
+        edges.sort()
+        end = edges[-1][0] + 4 * debounce + 2
+        for name, make in algorithms:
+            chatter, missed, latency = score(strokes, run(make(), keys, edges, args.scan_us, end))
+            print("%-8s %-12s %7d %6d %18s %18s" % (profile, name, chatter, missed, stats(latency[True]), stats(latency[False])))
+            if name.startswith("custom") and share <= 1 and (chatter or missed):
+                failed = True
+    if failed:
+        sys.exit("custom_debounce.c chattered or missed an edge within DEBOUNCE ms of bounce")
+
+
+if __name__ == "__main__":
+    main()
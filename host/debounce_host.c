@@ -0,0 +1,44 @@
+/*
+This is the c file of the debounce on the host
+
+./debounce_sim.py loads it as a shared object and runs debounce() of custom_debounce.c against its simulated bounce.
+custom_debounce.c is included, as keymap_host.c includes keymap.c: the simulation sets the ms clock and the game profile,
+and reads whether a timer is running, to skip the scans in which nothing can happen.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include "custom_debounce.c"
+
+const uint8_t debounce_host_ms   = DEBOUNCE; // as config.h sets it
+const uint8_t debounce_host_rows = MATRIX_ROWS;
+const uint8_t debounce_host_cols = MATRIX_COLS;
+
+static uint16_t host_time = 0;
+static bool     host_game = false;
+
+uint16_t timer_read(void) {
+    return host_time;
+}
+
+bool game_profile_active(void) {
+    return host_game;
+}
+
+void debounce_host_init(bool game) {
+    host_time = 0;
+    host_game = game;
+    debounce_init(MATRIX_ROWS);
+}
+
+// one scan at time ms, true if cooked changed
+bool debounce_host_scan(uint16_t time, matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
+    host_time = time;
+    return debounce(raw, cooked, MATRIX_ROWS, changed);
+}
+
+bool debounce_host_idle(void) {
+    return !counting; // debounce() returns at once until the raw matrix changes
+}
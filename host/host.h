@@ -0,0 +1,34 @@
+/*
+This is the header of the host harness: it drives the keymap through the host QMK of qmk_core.c
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "quantum.h"
+
+typedef void (*host_report_hook_t)(const report_keyboard_t *report);
+
+void     host_init(void);                           // boot: keyboard_post_init_user, OS detection, the trackpoint init starts
+void     host_key(uint8_t row, uint8_t col, bool closed); // set a switch of the raw matrix, seen at the next scan
+void     host_scan(void);                           // one pass of the main loop, one scan period later
+void     host_run_until(uint64_t us);               // scan until the clock reaches us
+uint64_t host_now_us(void);                         // simulated time since boot
+void     host_set_scan_us(uint32_t us);             // scan period, 250 us by default
+
+void     host_set_report_hook(host_report_hook_t hook); // called with every keyboard report the host gets
+uint32_t host_keyboard_reports(void);
+uint32_t host_mouse_reports(void);
+uint32_t host_extra_reports(void);
+uint32_t host_ps2_task_max_us(void); // longest pointing device task of the trackpoint init, the PS/2 wire time included
+uint32_t host_overrides_fired(void);        // key overrides activated by the press of their trigger
+uint32_t host_overrides_mispredicted(void); // presses on which key_override_index_firing() named another override, or none
+
+void     host_keymap_dump(void);             // the keymap's own statistics, as LAT_DUMP prints them
+uint8_t  host_game_layer(void);              // the first layer of the game profile
+uint16_t host_glyph_codepoint(uint8_t name); // codepoint of a unicode_name as the symbol lists of keymap.c give it, 0 past the last
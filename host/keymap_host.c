@@ -0,0 +1,67 @@
+/*
+This is the c file of the keymap on the host
+
+QMK builds keymap_introspection.c with the keymap included, so the _raw accessors can read its tables:
+this does the same for the host build, and lets the harness print the statistics LAT_DUMP prints.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include "keymap.c"
+#include "host.h"
+
+uint8_t keymap_layer_count_raw(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (layer_num < ARRAY_SIZE(keymaps) && row < MATRIX_ROWS && column < MATRIX_COLS) {
+        return pgm_read_word(&keymaps[layer_num][row][column]);
+    }
+    return KC_TRNS;
+}
+
+uint16_t combo_count_raw(void) {
+    return ARRAY_SIZE(key_combos);
+}
+
+combo_t *combo_get_raw(uint16_t combo_idx) {
+    return &key_combos[combo_idx];
+}
+
+uint16_t key_override_count_raw(void) {
+    return ARRAY_SIZE(key_overrides);
+}
+
+const key_override_t *key_override_get_raw(uint16_t key_override_idx) {
+    return key_overrides[key_override_idx];
+}
+
+void host_keymap_dump(void) {
+#if MY_LATENCY_STATS_ENABLE
+    lat_dump(); // not a LAT_DUMP press: it would count as a key event of its own
+    uprintf("double tap windows: end=%u home=%u ms\n", double_tap_window(&double_taps[0], NULL), double_tap_window(&double_taps[1], NULL));
+    uprintf("typing: %u ms between presses\n", tapping_term_interval());
+#endif
+}
+
+#if MY_UNICODE_ENABLE
+#    define HOST_CODEPOINT(name, ...) [name] = unicode_codepoint_##name,
+static const uint16_t host_codepoints[] = {
+    UNICODE_EXCEPTIONS(HOST_CODEPOINT)
+    UNICODE_RANGES(UNICODE_NONE, HOST_CODEPOINT)
+};
+#endif
+
+uint16_t host_glyph_codepoint(uint8_t name) {
+#if MY_UNICODE_ENABLE
+    if (name < ARRAY_SIZE(host_codepoints)) return host_codepoints[name];
+#endif
+    return 0;
+}
+
+uint8_t host_game_layer(void) {
+    return ADD_LAYER;
+}
@@ -0,0 +1,502 @@
+/*
+This is the c file of the PS/2 packet tests
+
+ps2_mouse_packet.h of PS2_patches/ps2_pointing_device.diff has no QMK dependencies: the Makefile extracts it
+from the patch and these tests feed it simulated trackpoint streams.
+A stream is a random walk of the stick, packets of -40 - 40 counts per axis with a button now and then,
+as 3 byte packets and as 4 byte ones with the wheel, sent at PS2_MOUSE_SAMPLE_RATE with a byte per ms
+and drained by a task every ms, or every 7 ms with stalls now and then: as in the driver, the task drains every
+byte queued by then with one timer read. Its timer starts just before the 16 bit wrap.
+A flick stream has a packet of 128 - 255 counts every 8 packets, some with the overflow bits set.
+The curve tests check the gain table built from PS2_MOUSE_ACCEL_BASE/SLOPE/MAX of config.h, the fraction carry,
+and that a task that stalls moves the cursor as far as one that reads each packet.
+The coalescing runs push the stick for a second at 200 Hz, read by a task every 1 or 10 ms that stalls now and then,
+once taking one packet per report as the driver used to, from a ring of OLD_RING_SIZE packets, and once adding
+each packet to the report as the assembler completes it.
+usage: ./ps2_packet_test [--seed N]
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ps2_mouse_packet.h"
+
+#define STREAM_PACKETS 64 // packets of one trial
+#define FAULT_PACKET 16   // the packet a trial corrupts
+#define TRIALS 2000       // per fault and packet size
+
+#define STREAM_MS 2000   // a coalescing run: the stick moves from 100 ms to 1100 ms at PS2_MOUSE_SAMPLE_RATE
+#define STALL_EVERY_MS 250 // the pointing device task stalls this often
+#define STALL_MS 30        // for this long
+#define OLD_RING_SIZE 8    // packets the driver queued when it took one per report
+
+#define RESYNC_BAD_MAX 1  // misaligned packets accepted after one lost or extra byte
+#define RESYNC_LOST_MAX 1 // good packets lost to it
+
+#ifndef PS2_MOUSE_SAMPLE_RATE
+#    define PS2_MOUSE_SAMPLE_RATE 100
+#endif
+#ifndef PS2_MOUSE_X_MULTIPLIER
+#    define PS2_MOUSE_X_MULTIPLIER 1
+#endif
+#define SAMPLE_MS (1000 / PS2_MOUSE_SAMPLE_RATE)
+#define START_MS 0xFF00
+
+typedef uint8_t packet_t[PS2_MOUSE_PACKET_MAX];
+
+static uint32_t rng_state = 1;
+static uint32_t failures  = 0;
+
+#define CHECK(condition, ...)          \
+    do {                               \
+        if (!(condition)) {            \
+            printf("FAIL: " __VA_ARGS__); \
+            failures++;                \
+        }                              \
+    } while (0)
+
+static uint32_t rng(void) { // xorshift32: the same run for the same seed on any libc
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int16_t walk(int16_t value) {
+    value += (int16_t)(rng() % 11) - 5;
+    return value < -40 ? -40 : value > 40 ? 40 : value;
+}
+
+static void make_packet(uint8_t *packet, int16_t x, int16_t y, int8_t v, uint8_t buttons) {
+    packet[0] = PS2_MOUSE_HEAD_ALWAYS_ONE | (buttons & PS2_MOUSE_HEAD_BUTTONS) | (x < 0 ? PS2_MOUSE_HEAD_X_SIGN : 0) | (y < 0 ? PS2_MOUSE_HEAD_Y_SIGN : 0);
+    packet[1] = x & 0xFF;
+    packet[2] = y & 0xFF;
+    packet[3] = v & 0xFF;
+}
+
+// a trackpoint stream of count packets
+static void make_stream(packet_t *stream, uint16_t count) {
+    int16_t x = 0, y = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        x = walk(x);
+        y = walk(y);
+        make_packet(stream[i], x, y, rng() % 8 == 0 ? (int8_t)(rng() % 3) - 1 : 0, rng() % 16 == 0 ? 1 << rng() % 3 : 0);
+    }
+}
+
+// flattens the stream with the ms each byte arrives at, lost drops the byte at fault, else it is sent twice
+static uint16_t corrupt(const packet_t *stream, uint16_t count, uint8_t size, uint16_t fault, bool lost, uint8_t *bytes, uint16_t *times) {
+    uint16_t length = 0;
+    for (uint16_t i = 0; i < count * size; i++) {
+        if (i == fault && lost) continue;
+        for (uint8_t copy = 0; copy < (i == fault ? 2 : 1); copy++) {
+            times[length]   = START_MS + i / size * SAMPLE_MS + i % size + 1;
+            bytes[length++] = stream[i / size][i % size];
+        }
+    }
+    return length;
+}
+
+// the bytes queued by the interrupt, with the ms each one arrived at
+typedef struct {
+    const uint8_t  *bytes;
+    const uint16_t *times;
+    uint16_t        length;
+    uint16_t        next; // the first byte the task has not drained
+} wire_t;
+
+// the task runs every task_ms, but not during a stall
+static bool task_due(uint16_t ms, uint8_t task_ms, bool stalls) {
+    return !(ms % task_ms) && !(stalls && ms % STALL_EVERY_MS < STALL_MS);
+}
+
+// one run of the task at now, as ps2_mouse_receive_packets(): every byte queued by then is drained with that now,
+// then the empty queue is checked for a reset and for a pause; returns the packets completed, arrived gets the ms of their last byte
+static uint16_t task_drain(ps2_mouse_assembler_t *assembler, wire_t *wire, uint16_t now, packet_t *out, uint16_t *arrived, bool *reset) {
+    uint16_t count = 0;
+    while (wire->next < wire->length && (int16_t)(now - wire->times[wire->next]) >= 0) {
+        if (ps2_mouse_assemble(assembler, wire->bytes[wire->next++], out[count], now)) {
+            if (arrived) arrived[count] = wire->times[wire->next - 1];
+            count++;
+        }
+    }
+    *reset = ps2_mouse_assembler_reset(assembler, now);
+    if (!*reset) ps2_mouse_assembler_idle(assembler, now);
+    return count;
+}
+
+// drains the bytes with a task every task_ms, until the last one had its pause
+static uint16_t assemble(const uint8_t *bytes, const uint16_t *times, uint16_t length, uint8_t size, uint8_t task_ms, bool stalls, packet_t *out, uint16_t *resyncs) {
+    ps2_mouse_assembler_t assembler = {0};
+    ps2_mouse_assembler_init(&assembler, size);
+
+    wire_t   wire      = {bytes, times, length, 0};
+    uint16_t out_count = 0, end = (uint16_t)(times[length - 1] - START_MS) + STALL_MS + task_ms + PS2_MOUSE_PACKET_TIMEOUT;
+    bool     reset;
+    for (uint16_t ms = 0; ms <= end; ms++) {
+        if (task_due(ms, task_ms, stalls)) out_count += task_drain(&assembler, &wire, START_MS + ms, out + out_count, NULL, &reset);
+    }
+    *resyncs = assembler.resyncs;
+    return out_count;
+}
+
+//    %----------%
+//    |  RESYNC  |
+//    %----------%
+
+// assembles a stream with one lost or extra byte, and checks how soon the packets line up again
+static void resync_trials(uint8_t size, bool lost) {
+    uint32_t resyncs = 0, bad_total = 0, lost_total = 0;
+    uint8_t  bad_max = 0, lost_max = 0;
+
+    for (uint16_t trial = 0; trial < TRIALS; trial++) {
+        packet_t stream[STREAM_PACKETS];
+        make_stream(stream, STREAM_PACKETS);
+        uint16_t fault = FAULT_PACKET * size + rng() % size;
+
+        uint8_t  bytes[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+        uint16_t times[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+        uint16_t length = corrupt(stream, STREAM_PACKETS, size, fault, lost, bytes, times);
+
+        packet_t out[STREAM_PACKETS * 2];
+        uint16_t trial_resyncs;
+        uint16_t out_count = assemble(bytes, times, length, size, 1, false, out, &trial_resyncs);
+
+        // the packets before the fault are untouched, then the stream must end on the packets after it
+        uint16_t same = 0;
+        while (same < out_count && same < FAULT_PACKET && !memcmp(out[same], stream[same], size)) same++;
+        CHECK(same == FAULT_PACKET, "%u byte packets: a packet before the fault changed\n", size);
+
+        uint16_t tail = 0;
+        while (tail < out_count - same && tail < STREAM_PACKETS - FAULT_PACKET &&
+               !memcmp(out[out_count - 1 - tail], stream[STREAM_PACKETS - 1 - tail], size)) {
+            tail++;
+        }
+        uint8_t bad = out_count - same - tail;                 // accepted between the fault and the realignment
+        uint8_t gone = STREAM_PACKETS - FAULT_PACKET - tail;   // originals from the faulty one on that never came out
+        CHECK(tail >= STREAM_PACKETS - FAULT_PACKET - RESYNC_LOST_MAX, "%u byte packets: still misaligned at the end of the stream\n", size);
+
+        resyncs += trial_resyncs;
+        bad_total += bad;
+        lost_total += gone;
+        if (bad > bad_max) bad_max = bad;
+        if (gone > lost_max) lost_max = gone;
+    }
+
+    printf("resync %u byte packets, one %s byte in %u streams: resyncs=%lu bad packets avg=%.2f max=%u lost packets avg=%.2f max=%u\n",
+           size, lost ? "lost" : "extra", TRIALS, (unsigned long)resyncs, (double)bad_total / TRIALS, bad_max, (double)lost_total / TRIALS, lost_max);
+    CHECK(bad_max <= RESYNC_BAD_MAX, "%u byte packets: %u misaligned packets accepted, at most %u\n", size, bad_max, RESYNC_BAD_MAX);
+    CHECK(lost_max <= RESYNC_LOST_MAX, "%u byte packets: %u packets lost, at most %u\n", size, lost_max, RESYNC_LOST_MAX);
+    CHECK(resyncs == TRIALS, "%u byte packets: %lu resyncs counted for %u faults\n", size, (unsigned long)resyncs, TRIALS);
+}
+
+// a clean stream goes through unchanged and never counts a resync, also with a task that runs late
+static void clean_stream(uint8_t size, uint8_t task_ms, bool stalls) {
+    packet_t stream[STREAM_PACKETS];
+    make_stream(stream, STREAM_PACKETS);
+
+    uint8_t  bytes[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+    uint16_t times[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+    uint16_t length = corrupt(stream, STREAM_PACKETS, size, UINT16_MAX, true, bytes, times);
+
+    packet_t out[STREAM_PACKETS + 1];
+    uint16_t resyncs;
+    uint16_t out_count = assemble(bytes, times, length, size, task_ms, stalls, out, &resyncs);
+    for (uint16_t i = 0; i < out_count; i++) {
+        CHECK(!memcmp(out[i], stream[i], size), "%u byte packets, task every %u ms: clean packet %u changed\n", size, task_ms, i);
+    }
+    CHECK(out_count == STREAM_PACKETS, "%u byte packets, task every %u ms: %u of %u clean packets\n", size, task_ms, out_count, STREAM_PACKETS);
+    CHECK(resyncs == 0, "%u byte packets, task every %u ms: %u resyncs on a clean stream\n", size, task_ms, resyncs);
+}
+
+// a flick past 127 counts, with the sign bit apart from the top bit of its byte or an overflow, goes through once in sync
+static void flick(uint8_t size) {
+    packet_t stream[STREAM_PACKETS];
+    make_stream(stream, STREAM_PACKETS);
+    for (uint16_t i = 8; i < STREAM_PACKETS; i += 8) {
+        int16_t speed = 128 + rng() % 128;
+        make_packet(stream[i], i % 16 ? speed : -speed, i % 16 ? -speed : speed, 0, 0);
+        if (i % 32 == 0) stream[i][0] |= PS2_MOUSE_HEAD_OVERFLOW; // past 255 counts
+    }
+
+    uint8_t  bytes[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+    uint16_t times[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 1];
+    uint16_t length = corrupt(stream, STREAM_PACKETS, size, UINT16_MAX, true, bytes, times);
+
+    packet_t out[STREAM_PACKETS + 1];
+    uint16_t resyncs;
+    uint16_t out_count = assemble(bytes, times, length, size, 1, false, out, &resyncs);
+    for (uint16_t i = 0; i < out_count; i++) {
+        CHECK(!memcmp(out[i], stream[i], size), "%u byte packets: flick packet %u changed\n", size, i);
+    }
+    CHECK(out_count == STREAM_PACKETS && resyncs == 0, "%u byte packets: %u of %u packets with flicks, %u resyncs\n", size, out_count, STREAM_PACKETS, resyncs);
+    printf("flick %u byte packets: %u of %u packets through, %u of them over 127 counts, resyncs=%u\n", size, out_count, STREAM_PACKETS, STREAM_PACKETS / 8 - 1, resyncs);
+}
+
+// a packet that starts like a self test result is never a reset, the same two bytes left alone are one
+static void reset_detection(uint8_t size, uint8_t task_ms, bool stalls) {
+    packet_t stream[STREAM_PACKETS];
+    make_stream(stream, STREAM_PACKETS);
+    for (uint16_t i = 0; i < STREAM_PACKETS; i += 8) {
+        stream[i][0] = PS2_MOUSE_BAT_OK;
+        stream[i][1] = 0x00;
+    }
+
+    uint8_t  bytes[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 2];
+    uint16_t times[STREAM_PACKETS * PS2_MOUSE_PACKET_MAX + 2];
+    uint16_t length = corrupt(stream, STREAM_PACKETS, size, UINT16_MAX, true, bytes, times);
+
+    // then the mouse resets: its self test result and device ID, and nothing after them
+    uint16_t reset_ms = (uint16_t)(times[length - 1] - START_MS) + SAMPLE_MS;
+    times[length]     = START_MS + reset_ms;
+    bytes[length++]   = PS2_MOUSE_BAT_OK;
+    times[length]     = START_MS + reset_ms + 1;
+    bytes[length++]   = 0x00;
+
+    ps2_mouse_assembler_t assembler = {0};
+    ps2_mouse_assembler_init(&assembler, size);
+
+    wire_t   wire   = {bytes, times, length, 0};
+    uint16_t resets = 0, seen = 0;
+    for (uint16_t ms = 0; ms <= reset_ms + 1 + PS2_MOUSE_PACKET_TIMEOUT + task_ms + STALL_MS && !seen; ms++) {
+        packet_t out[STREAM_PACKETS];
+        bool     reset;
+        if (!task_due(ms, task_ms, stalls)) continue;
+        task_drain(&assembler, &wire, START_MS + ms, out, NULL, &reset);
+        if (!reset) continue;
+        if (ms < reset_ms) {
+            resets++;
+        } else {
+            seen = ms;
+        }
+    }
+    CHECK(resets == 0, "%u byte packets, task every %u ms: %u resets seen in a stream\n", size, task_ms, resets);
+    CHECK(seen, "%u byte packets, task every %u ms: a reset missed\n", size, task_ms);
+    CHECK(!seen || seen >= reset_ms + 1 + PS2_MOUSE_PACKET_TIMEOUT, "%u byte packets, task every %u ms: a reset seen %u ms after the device ID\n", size, task_ms, seen - reset_ms - 1);
+}
+
+//    %--------------%
+//    |  COALESCING  |
+//    %--------------%
+
+typedef struct {
+    uint32_t lag_total; // ms from the last byte of a packet to the report that takes it
+    uint16_t lag_max;
+    uint32_t popped;
+    uint16_t dropped;   // by the full ring of the old driver
+    uint8_t  per_report_max;
+    int16_t  carry_max; // counts left for the next report
+    uint16_t settle;    // ms from the last packet to the last report that moves
+} lag_t;
+
+// adds a packet that arrived at at to the report of the task at now
+static void lag_take(lag_t *lag, ps2_mouse_motion_t *motion, const uint8_t *packet, uint16_t at, uint16_t now, int16_t *remainder_x, int16_t *remainder_y) {
+    ps2_mouse_motion_add(motion, packet, remainder_x, remainder_y);
+    lag->lag_total += now - at;
+    if (now - at > lag->lag_max) lag->lag_max = now - at;
+    lag->popped++;
+}
+
+// a fast push of the stick at rate Hz, read every task_ms by a task that adds every packet it completes or queues them and takes one
+static void lag_run(uint16_t rate, uint8_t task_ms, bool coalesce, lag_t *lag) {
+    ps2_mouse_assembler_t assembler = {0};
+    ps2_mouse_assembler_init(&assembler, 3);
+    memset(lag, 0, sizeof(*lag));
+
+    // the bytes queued by the interrupt, one per ms from each sample on
+    uint16_t sample_ms = 1000 / rate;
+    uint8_t  bytes[1000 * 3];
+    uint16_t times[1000 * 3];
+    uint16_t length = 0;
+    int16_t  x      = 30;
+    for (uint16_t sample = 0; sample < 1000 / sample_ms; sample++) {
+        packet_t packet;
+        x = walk(x - 30) + 30; // 0 - 70 counts per sample
+        make_packet(packet, x, 0, 0, 0);
+        for (uint8_t i = 0; i < 3; i++) {
+            times[length]   = 100 + sample * sample_ms + i;
+            bytes[length++] = packet[i];
+        }
+    }
+
+    wire_t   wire = {bytes, times, length, 0};
+    packet_t ring[OLD_RING_SIZE];
+    uint16_t ring_at[OLD_RING_SIZE]; // ms each packet of the ring arrived at
+    uint8_t  waiting = 0;
+    uint16_t last_packet = 0, last_motion = 0;
+    int16_t  carry = 0, remainder_x = 0, remainder_y = 0;
+
+    for (uint16_t now = 0; now < STREAM_MS; now++) {
+        if (!task_due(now, task_ms, true)) continue; // the task is stalled, or not due
+
+        packet_t           done[STALL_MS + 16];
+        uint16_t           done_at[STALL_MS + 16];
+        bool               reset;
+        ps2_mouse_motion_t motion = {0};
+        uint16_t           count  = task_drain(&assembler, &wire, now, done, done_at, &reset);
+        for (uint16_t i = 0; i < count; i++) {
+            last_packet = done_at[i];
+            if (coalesce) {
+                lag_take(lag, &motion, done[i], done_at[i], now, &remainder_x, &remainder_y);
+            } else if (waiting < OLD_RING_SIZE) {
+                memcpy(ring[waiting], done[i], 3);
+                ring_at[waiting++] = done_at[i];
+            } else {
+                lag->dropped++;
+            }
+        }
+        if (!coalesce && waiting) {
+            lag_take(lag, &motion, ring[0], ring_at[0], now, &remainder_x, &remainder_y);
+            memmove(ring, ring + 1, --waiting * sizeof(ring[0]));
+            memmove(ring_at, ring_at + 1, waiting * sizeof(ring_at[0]));
+        }
+        if (motion.packets > lag->per_report_max) lag->per_report_max = motion.packets;
+
+        carry += motion.x * PS2_MOUSE_X_MULTIPLIER;
+        if (ps2_mouse_motion_take(&carry, -127, 127)) last_motion = now;
+        if (carry > lag->carry_max) lag->carry_max = carry;
+    }
+    lag->settle = last_motion - last_packet;
+}
+
+// a packet waits for the task at most a stall and a task period, and the cursor stops with the stick
+static void coalescing(uint16_t rate, uint8_t task_ms) {
+    lag_t    one, all;
+    uint32_t seed = rng_state;
+    lag_run(rate, task_ms, false, &one);
+    rng_state = seed; // the same stick for both
+    lag_run(rate, task_ms, true, &all);
+
+    for (uint8_t i = 0; i < 2; i++) {
+        lag_t *lag = i ? &all : &one;
+        printf("coalesce %u Hz, task every %u ms, %u ms stall every %u ms, %s: lag avg=%.1f max=%u ms packets=%lu dropped=%u per report max=%u carry max=%d settle=%u ms\n",
+               rate, task_ms, STALL_MS, STALL_EVERY_MS, i ? "all packets" : "one packet", lag->popped ? (double)lag->lag_total / lag->popped : 0, lag->lag_max,
+               (unsigned long)lag->popped, lag->dropped, lag->per_report_max, lag->carry_max, lag->settle);
+    }
+    CHECK(all.lag_max <= STALL_MS + task_ms, "%u Hz: a packet waited %u ms, the stall is %u ms\n", rate, all.lag_max, STALL_MS);
+    CHECK(all.carry_max <= PS2_MOUSE_MOTION_CARRY_MAX, "%u Hz: %d counts carried\n", rate, all.carry_max);
+    CHECK(all.settle <= 2 * task_ms, "%u Hz: the cursor moved %u ms after the stick stopped\n", rate, all.settle);
+}
+
+
+//    %---------%
+//    |  CURVE  |
+//    %---------%
+
+static uint16_t expected_gain(uint16_t speed) {
+    if (speed >= PS2_MOUSE_ACCEL_STEPS) speed = PS2_MOUSE_ACCEL_STEPS - 1;
+    uint32_t gain = PS2_MOUSE_ACCEL_BASE + (uint32_t)PS2_MOUSE_ACCEL_SLOPE * speed;
+    return gain < PS2_MOUSE_ACCEL_MAX ? gain : PS2_MOUSE_ACCEL_MAX;
+}
+
+// the table the preprocessor built, and one packet of each speed from a clean remainder
+static void curve_table(void) {
+    for (uint16_t speed = 0; speed < PS2_MOUSE_ACCEL_STEPS; speed++) {
+        CHECK(ps2_mouse_accel_curve[speed] == expected_gain(speed), "curve: gain 0x%04X at speed %u, not 0x%04X\n", ps2_mouse_accel_curve[speed], speed, expected_gain(speed));
+        CHECK(!speed || ps2_mouse_accel_curve[speed] >= ps2_mouse_accel_curve[speed - 1], "curve: the gain drops at speed %u\n", speed);
+    }
+    for (int16_t delta = -300; delta <= 300; delta++) {
+        int16_t remainder = 0;
+        int32_t scaled    = (int32_t)delta * expected_gain(delta < 0 ? -delta : delta);
+        int16_t out       = ps2_mouse_accelerate(delta, &remainder);
+        CHECK(out == scaled / 256 && remainder == scaled % 256, "curve: %d counts gave %d and %d/256, not %ld and %ld/256\n", delta, out, remainder, (long)(scaled / 256), (long)(scaled % 256));
+    }
+}
+
+// the fractions of a push in one direction add up to whole counts: nothing is rounded away
+static void curve_remainder(void) {
+    for (int8_t sign = -1; sign <= 1; sign += 2) {
+        for (uint8_t speed = 1; speed <= 3; speed++) {
+            int16_t remainder = 0;
+            int32_t total = 0, scaled = 0;
+            for (uint16_t packet = 0; packet < 1000; packet++) {
+                total += ps2_mouse_accelerate(sign * speed, &remainder);
+                scaled += sign * speed * expected_gain(speed);
+            }
+            CHECK(total * 256 + remainder == scaled, "remainder: 1000 packets of %d moved %ld and %d/256, not %ld/256\n", sign * speed, (long)total, remainder, (long)scaled);
+            CHECK(remainder > -256 && remainder < 256 && (remainder == 0 || (remainder < 0) == (sign < 0)), "remainder: %d/256 left after a push of %d\n", remainder, sign * speed);
+        }
+    }
+
+    // a random push in one direction, then the stick turns back: the old fraction is dropped
+    int16_t remainder = 0;
+    int32_t total = 0, scaled = 0;
+    for (uint16_t packet = 0; packet < 1000; packet++) {
+        int16_t delta = rng() % 40;
+        total += ps2_mouse_accelerate(delta, &remainder);
+        scaled += delta * expected_gain(delta);
+    }
+    CHECK(total * 256 + remainder == scaled, "remainder: a random push moved %ld and %d/256, not %ld/256\n", (long)total, remainder, (long)scaled);
+    int16_t back = ps2_mouse_accelerate(-1, &remainder);
+    CHECK(back * 256 + remainder == -expected_gain(1), "remainder: turning back gave %d and %d/256, not -%u/256\n", back, remainder, expected_gain(1));
+    printf("curve: gain 0x%04X at 1 count, 0x%04X from %u counts per sample on; 1000 packets of 1 count move %ld counts\n", expected_gain(1), expected_gain(PS2_MOUSE_ACCEL_STEPS),
+           PS2_MOUSE_ACCEL_STEPS - 1, (long)(1000L * expected_gain(1) / 256));
+}
+
+// a push at 200 Hz read every sample, and read by a task that stalls and then finds several packets waiting
+static void curve_stall(void) {
+    ps2_mouse_motion_t each = {0}, stalled = {0};
+    int16_t            remainder[2][2] = {{0}}, sum_remainder = 0, x = 0, sum = 0;
+    int32_t            moved_each = 0, moved_stalled = 0, moved_sum = 0;
+
+    for (uint16_t now = 0; now < STREAM_MS; now += 5) {
+        packet_t packet;
+        x = walk(x);
+        make_packet(packet, x, -x, 0, 0);
+
+        ps2_mouse_motion_add(&each, packet, &remainder[0][0], &remainder[0][1]);
+        moved_each += each.x;
+        each = (ps2_mouse_motion_t){0};
+
+        ps2_mouse_motion_add(&stalled, packet, &remainder[1][0], &remainder[1][1]);
+        sum += x;
+        if (now % STALL_EVERY_MS < STALL_MS && now + 5 < STREAM_MS) continue; // the packets wait for the task
+        CHECK(stalled.x == -stalled.y, "curve: a stalled report moved %d and %d for the same counts\n", stalled.x, stalled.y);
+        moved_stalled += stalled.x;
+        moved_sum += ps2_mouse_accelerate(sum, &sum_remainder); // the curve applied to the sum, as before
+        stalled = (ps2_mouse_motion_t){0};
+        sum     = 0;
+    }
+    CHECK(moved_stalled == moved_each && remainder[1][0] == remainder[0][0], "curve: %ld counts through %u ms stalls, %ld read packet by packet\n", (long)moved_stalled,
+          STALL_MS, (long)moved_each);
+    printf("curve: a push with %u ms stalls every %u ms moved %ld counts, %ld read packet by packet (the curve on the sums: %ld)\n", STALL_MS, STALL_EVERY_MS,
+           (long)moved_stalled, (long)moved_each, (long)moved_sum);
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            rng_state = strtoul(argv[++i], NULL, 0) | 1;
+        } else {
+            fprintf(stderr, "usage: %s [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint8_t size = 3; size <= 4; size++) {
+        clean_stream(size, 1, false);
+        clean_stream(size, 1, true);
+        clean_stream(size, 7, true);
+        flick(size);
+        reset_detection(size, 1, false);
+        reset_detection(size, 7, true);
+        resync_trials(size, true);
+        resync_trials(size, false);
+    }
+    curve_table();
+    curve_remainder();
+    curve_stall();
+    coalescing(200, 1);
+    coalescing(200, 10); // a throttled task is slower than the stream
+
+    if (failures) {
+        printf("ps2 packet tests: %lu failures\n", (unsigned long)failures);
+        return 1;
+    }
+    printf("ps2 packet tests: passed\n");
+    return 0;
+}
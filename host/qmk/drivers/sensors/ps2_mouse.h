@@ -0,0 +1,15 @@
+// drivers/sensors/ps2_mouse.h of the host QMK: the driver calls of the keymap and trackpoint.c, answered by qmk_core.c
+// the header of the patch is a diff against QMK's drivers/ps2/ps2_mouse.h and cannot be rebuilt from the repo alone
+#pragma once
+#include "quantum.h"
+
+void     ps2_mouse_enable_data_reporting(void);
+void     ps2_mouse_disable_data_reporting(void);
+void     ps2_mouse_poll_now(void);
+uint16_t ps2_mouse_resync_count(void);
+uint16_t ps2_mouse_error_count(void);
+uint16_t ps2_mouse_recovery_count(void);
+bool     ps2_mouse_is_ready(void);
+uint32_t ps2_mouse_ready_time(void);
+bool     ps2_mouse_configure_user(void);
+void     ps2_mouse_ready_user(void);
@@ -0,0 +1,14 @@
+// ps2.h of the host QMK: the PS/2 host interface, answered by the register file of a trackpoint in qmk_core.c
+#pragma once
+#include "quantum.h"
+
+#define PS2_ACK 0xFA
+#define PS2_RESEND 0xFE
+#define PS2_ERR_NONE 0
+
+extern uint8_t ps2_error;
+
+void    ps2_host_init(void);
+uint8_t ps2_host_send(uint8_t data);
+uint8_t ps2_host_recv_response(void);
+uint8_t ps2_host_recv(void);
@@ -0,0 +1,539 @@
+/*
+This is the header of the host QMK: the part of QMK's API the keymap uses, for a native build on the computer
+
+The types, keycodes and macros follow QMK (end of 2025) where the keymap depends on their values,
+the functions are implemented by qmk_core.c. It is QMK_KEYBOARD_H of the host build, and the other QMK headers
+the keymap includes (action.h, debounce.h, ...) are one-line includes of this one.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h> // before the dprintf macro
+#include <string.h>
+
+// crkbd: both halves as one 8x6 matrix, the right half below the left one
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 6
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define wait_ms(ms)
+#define wait_us(us)
+
+
+// timer
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+#define TIMER_DIFF_32(a, b) ((uint32_t)((a) - (b)))
+
+
+// console: uprintf takes QMK's %lu for uint32_t, which is unsigned long on the keyboard
+
+void uprintf(const char *format, ...);
+#define debug_enable false
+#define dprintf(...)                           \
+    do {                                       \
+        if (debug_enable) uprintf(__VA_ARGS__); \
+    } while (0)
+#define pd_dprintf(...) dprintf(__VA_ARGS__)
+
+
+// matrix and events
+
+typedef uint8_t matrix_row_t;
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum { TICK_EVENT = 0, KEY_EVENT = 1, ENCODER_CW_EVENT = 2, ENCODER_CCW_EVENT = 3, COMBO_EVENT = 4 } keyevent_type_t;
+
+typedef struct {
+    keypos_t        key;
+    uint16_t        time;
+    keyevent_type_t type;
+    bool            pressed;
+} keyevent_t;
+
+typedef struct {
+    bool    interrupted : 1;
+    bool    reserved2 : 1;
+    bool    reserved1 : 1;
+    bool    reserved0 : 1;
+    uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+    keyevent_t event;
+    tap_t      tap;
+    uint16_t   keycode; // COMBO_ENABLE: the keycode of a combo event
+} keyrecord_t;
+
+#define KEYLOC_COMBO 254
+#define MAKE_KEYPOS(row_num, col_num) ((keypos_t){.row = (row_num), .col = (col_num)})
+#define MAKE_EVENT(row_num, col_num, press, event_type) \
+    ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = timer_read() | 1, .type = (event_type)})
+#define MAKE_KEYEVENT(row_num, col_num, press) MAKE_EVENT((row_num), (col_num), (press), KEY_EVENT)
+#define MAKE_COMBOEVENT(press) MAKE_EVENT(KEYLOC_COMBO, KEYLOC_COMBO, (press), COMBO_EVENT)
+#define IS_NOEVENT(event) ((event).type == TICK_EVENT || ((event).type != COMBO_EVENT && (event).time == 0))
+#define IS_EVENT(event) (!IS_NOEVENT(event))
+
+matrix_row_t matrix_get_row(uint8_t row);
+bool         matrix_is_on(uint8_t row, uint8_t col);
+void         action_exec(keyevent_t event);
+
+
+// keycodes
+
+enum qk_keycode_defines {
+    KC_NO = 0x0000,
+    KC_TRNS = 0x0001,
+    KC_A = 0x0004, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1 = 0x001E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENTER = 0x0028, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE, KC_MINUS, KC_EQUAL, KC_LEFT_BRACKET, KC_RIGHT_BRACKET,
+    KC_BACKSLASH, KC_NONUS_HASH, KC_SEMICOLON, KC_QUOTE, KC_GRAVE, KC_COMMA, KC_DOT, KC_SLASH, KC_CAPS_LOCK,
+    KC_F1 = 0x003A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+    KC_PRINT_SCREEN = 0x0046, KC_SCROLL_LOCK, KC_PAUSE, KC_INSERT, KC_HOME, KC_PAGE_UP, KC_DELETE, KC_END, KC_PAGE_DOWN,
+    KC_RIGHT, KC_LEFT, KC_DOWN, KC_UP, KC_NUM_LOCK, KC_KP_SLASH, KC_KP_ASTERISK, KC_KP_MINUS, KC_KP_PLUS,
+    KC_SYSTEM_POWER = 0x00A5,
+    KC_AUDIO_MUTE = 0x00A8, KC_AUDIO_VOL_UP, KC_AUDIO_VOL_DOWN,
+    KC_MEDIA_PLAY_PAUSE = 0x00AE,
+    KC_CALCULATOR = 0x00B2,
+    KC_BRIGHTNESS_UP = 0x00BD, KC_BRIGHTNESS_DOWN,
+    QK_MOUSE_BUTTON_1 = 0x00D1, QK_MOUSE_BUTTON_2, QK_MOUSE_BUTTON_3, QK_MOUSE_BUTTON_4, QK_MOUSE_BUTTON_5,
+    QK_MOUSE_WHEEL_UP = 0x00D9, QK_MOUSE_WHEEL_DOWN, QK_MOUSE_WHEEL_LEFT, QK_MOUSE_WHEEL_RIGHT,
+    QK_MOUSE_ACCELERATION_0 = 0x00DD, QK_MOUSE_ACCELERATION_1, QK_MOUSE_ACCELERATION_2,
+    KC_LEFT_CTRL = 0x00E0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI, KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI,
+    QK_MODS = 0x0100,
+    QK_MOD_TAP = 0x2000,
+    QK_LAYER_TAP = 0x4000,
+    QK_TOGGLE_LAYER = 0x5260,
+    QK_UNDERGLOW_TOGGLE = 0x7820,
+    QK_CLEAR_EEPROM = 0x7C03,
+    QK_CAPS_WORD_TOGGLE = 0x7C73,
+    QK_KB = 0x7E00,
+    QK_USER = 0x7E40,
+    QK_UNICODEMAP = 0x8000,
+    QK_UNICODEMAP_PAIR = 0xC000,
+    SAFE_RANGE = QK_USER,
+};
+
+#define XXXXXXX KC_NO
+#define _______ KC_TRNS
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_INS KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_PSLS KC_KP_SLASH
+#define KC_PAST KC_KP_ASTERISK
+#define KC_PMNS KC_KP_MINUS
+#define KC_PPLS KC_KP_PLUS
+#define KC_PWR KC_SYSTEM_POWER
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_CALC KC_CALCULATOR
+#define KC_BRIU KC_BRIGHTNESS_UP
+#define KC_BRID KC_BRIGHTNESS_DOWN
+#define MS_BTN1 QK_MOUSE_BUTTON_1
+#define MS_BTN2 QK_MOUSE_BUTTON_2
+#define MS_BTN3 QK_MOUSE_BUTTON_3
+#define MS_BTN4 QK_MOUSE_BUTTON_4
+#define MS_BTN5 QK_MOUSE_BUTTON_5
+#define MS_WHLU QK_MOUSE_WHEEL_UP
+#define MS_WHLD QK_MOUSE_WHEEL_DOWN
+#define MS_WHLL QK_MOUSE_WHEEL_LEFT
+#define MS_WHLR QK_MOUSE_WHEEL_RIGHT
+#define MS_ACL0 QK_MOUSE_ACCELERATION_0
+#define MS_ACL1 QK_MOUSE_ACCELERATION_1
+#define MS_ACL2 QK_MOUSE_ACCELERATION_2
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define UG_TOGG QK_UNDERGLOW_TOGGLE
+#define EE_CLR QK_CLEAR_EEPROM
+#define CW_TOGG QK_CAPS_WORD_TOGGLE
+
+// modded keycodes
+#define LCTL(kc) (QK_MODS | 0x0100 | (kc))
+#define LSFT(kc) (QK_MODS | 0x0200 | (kc))
+#define LALT(kc) (QK_MODS | 0x0400 | (kc))
+#define LGUI(kc) (QK_MODS | 0x0800 | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+#define LCS(kc) (QK_MODS | 0x0300 | (kc))
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+#define IS_QK_MODS(kc) ((kc) >= QK_MODS && (kc) <= 0x1FFF)
+
+#define KC_TILD S(KC_GRV)
+#define KC_EXLM S(KC_1)
+#define KC_AT S(KC_2)
+#define KC_HASH S(KC_3)
+#define KC_DLR S(KC_4)
+#define KC_PERC S(KC_5)
+#define KC_CIRC S(KC_6)
+#define KC_AMPR S(KC_7)
+#define KC_ASTR S(KC_8)
+#define KC_LPRN S(KC_9)
+#define KC_RPRN S(KC_0)
+#define KC_UNDS S(KC_MINS)
+#define KC_PLUS S(KC_EQL)
+#define KC_LCBR S(KC_LBRC)
+#define KC_RCBR S(KC_RBRC)
+#define KC_PIPE S(KC_BSLS)
+#define KC_COLN S(KC_SCLN)
+#define KC_DQUO S(KC_QUOTE)
+#define KC_DQT KC_DQUO
+#define KC_LT S(KC_COMM)
+#define KC_GT S(KC_DOT)
+#define KC_QUES S(KC_SLSH)
+
+// mods: 5 bit in keycodes (bit 4 for the right side), 8 bit in the report
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_RCTL 0x11
+#define MOD_RSFT 0x12
+#define MOD_RALT 0x14
+#define MOD_RGUI 0x18
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_MASK_CTRL (MOD_BIT(KC_LCTL) | MOD_BIT(KC_RCTL))
+#define MOD_MASK_SHIFT (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT))
+#define MOD_MASK_ALT (MOD_BIT(KC_LALT) | MOD_BIT(KC_RALT))
+#define MOD_MASK_GUI (MOD_BIT(KC_LGUI) | MOD_BIT(KC_RGUI))
+#define MOD_MASK_CS (MOD_MASK_CTRL | MOD_MASK_SHIFT)
+#define MOD_MASK_CA (MOD_MASK_CTRL | MOD_MASK_ALT)
+#define MOD_MASK_SA (MOD_MASK_SHIFT | MOD_MASK_ALT)
+#define IS_MODIFIER_KEYCODE(code) ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+#define IS_MOUSE_KEYCODE(code) ((code) >= 0x00CD && (code) <= 0x00DF)
+
+// hold-tap and layers
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= 0x3FFF)
+#define IS_QK_LAYER_TAP(code) ((code) >= QK_LAYER_TAP && (code) <= 0x4FFF)
+#define IS_QK_TOGGLE_LAYER(code) ((code) >= QK_TOGGLE_LAYER && (code) <= 0x527F)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+
+// unicode map
+#define UM(i) (QK_UNICODEMAP | ((i) & 0x3FFF))
+#define UP(i, j) (QK_UNICODEMAP_PAIR | ((i) & 0x7F) | (((j) & 0x7F) << 7))
+#define IS_QK_UNICODEMAP(code) ((code) >= QK_UNICODEMAP && (code) <= 0xBFFF)
+#define IS_QK_UNICODEMAP_PAIR(code) ((code) >= QK_UNICODEMAP_PAIR)
+#define QK_UNICODEMAP_GET_INDEX(kc) ((kc) & 0x3FFF)
+#define QK_UNICODEMAP_PAIR_GET_UNSHIFTED_INDEX(kc) ((kc) & 0x7F)
+#define QK_UNICODEMAP_PAIR_GET_SHIFTED_INDEX(kc) (((kc) >> 7) & 0x7F)
+
+// the crkbd layout: the right half is wired mirrored, the thumbs on the last three columns of the fourth rows
+// clang-format off
+#define LAYOUT_split_3x6_3( \
+    L00, L01, L02, L03, L04, L05, R00, R01, R02, R03, R04, R05, \
+    L10, L11, L12, L13, L14, L15, R10, R11, R12, R13, R14, R15, \
+    L20, L21, L22, L23, L24, L25, R20, R21, R22, R23, R24, R25, \
+                   L30, L31, L32, R30, R31, R32                 \
+) { \
+    {L00, L01, L02, L03, L04, L05}, \
+    {L10, L11, L12, L13, L14, L15}, \
+    {L20, L21, L22, L23, L24, L25}, \
+    {KC_NO, KC_NO, KC_NO, L30, L31, L32}, \
+    {R05, R04, R03, R02, R01, R00}, \
+    {R15, R14, R13, R12, R11, R10}, \
+    {R25, R24, R23, R22, R21, R20}, \
+    {KC_NO, KC_NO, KC_NO, R32, R31, R30} \
+}
+// clang-format on
+
+
+// layers
+
+typedef uint32_t layer_state_t;
+#define MAX_LAYER 32
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+layer_state_t layer_state_set(layer_state_t state);
+void          layer_on(uint8_t layer);
+void          layer_off(uint8_t layer);
+void          layer_move(uint8_t layer);
+void          layer_invert(uint8_t layer);
+bool          layer_state_is(uint8_t layer);
+uint8_t       get_highest_layer(layer_state_t state);
+uint8_t       layer_switch_get_layer(keypos_t key);
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column);
+uint8_t  keymap_layer_count(void);
+uint8_t  keymap_layer_count_raw(void);
+
+
+// mods and keys
+
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    set_mods(uint8_t mods);
+void    clear_mods(void);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void    register_mods(uint8_t mods);
+void    unregister_mods(uint8_t mods);
+void    register_weak_mods(uint8_t mods);
+void    unregister_weak_mods(uint8_t mods);
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+void send_keyboard_report(void);
+
+void caps_word_on(void);
+void caps_word_off(void);
+bool is_caps_word_on(void);
+void mousekey_on(uint8_t code);
+
+
+// host
+
+typedef struct {
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t keys[6];
+} report_keyboard_t;
+
+typedef struct {
+    uint8_t buttons;
+    int8_t  x;
+    int8_t  y;
+    int8_t  v;
+    int8_t  h;
+} report_mouse_t;
+
+typedef struct {
+    uint8_t  report_id;
+    uint16_t usage;
+} report_extra_t;
+
+typedef struct {
+    uint8_t (*keyboard_leds)(void);
+    void (*send_keyboard)(report_keyboard_t *report);
+    void (*send_nkro)(void *report);
+    void (*send_mouse)(report_mouse_t *report);
+    void (*send_extra)(report_extra_t *report);
+} host_driver_t;
+
+host_driver_t *host_get_driver(void);
+void           host_set_driver(host_driver_t *driver);
+
+typedef union {
+    uint8_t raw;
+    struct {
+        bool num_lock : 1;
+        bool caps_lock : 1;
+        bool scroll_lock : 1;
+        bool compose : 1;
+        bool kana : 1;
+        uint8_t reserved : 3;
+    };
+} led_t;
+
+led_t host_keyboard_led_state(void);
+
+void raw_hid_send(uint8_t *data, uint8_t length);
+
+
+// hold-tap
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
+bool     get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record);
+bool     get_retro_tapping(uint16_t keycode, keyrecord_t *record);
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record);
+#define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
+#define GET_QUICK_TAP_TERM(keycode, record) get_quick_tap_term(keycode, record)
+
+
+// combos
+
+typedef struct {
+    const uint16_t *keys;
+    uint16_t        keycode;
+    bool            disabled;
+    bool            active;
+    uint8_t         state; // a bit per key of the combo that is down
+} combo_t;
+
+#define COMBO_END 0
+#define COMBO(ck, ca) {.keys = &(ck)[0], .keycode = (ca)}
+#ifndef COMBO_TERM
+#    define COMBO_TERM 50
+#endif
+
+uint16_t combo_count(void);
+combo_t *combo_get(uint16_t combo_idx);
+uint16_t combo_count_raw(void);
+combo_t *combo_get_raw(uint16_t combo_idx);
+bool     process_combo(uint16_t keycode, keyrecord_t *record);
+void     combo_enable(void);
+void     combo_disable(void);
+bool     is_combo_enabled(void);
+
+
+// key overrides
+
+typedef enum {
+    ko_option_activation_trigger_down = (1 << 0),
+    ko_option_activation_required_mod_down = (1 << 1),
+    ko_option_activation_negative_mod_up = (1 << 2),
+    ko_option_one_mod = (1 << 3),
+    ko_option_no_reregister_trigger = (1 << 4),
+    ko_option_no_unregister_on_other_key_down = (1 << 5),
+    ko_options_all_activations = ko_option_activation_negative_mod_up | ko_option_activation_required_mod_down | ko_option_activation_trigger_down,
+    ko_options_default = ko_options_all_activations,
+} ko_option_t;
+
+typedef struct {
+    uint16_t      trigger;
+    uint8_t       trigger_mods;
+    layer_state_t layers;
+    uint8_t       negative_mod_mask;
+    uint8_t       suppressed_mods;
+    uint16_t      replacement;
+    ko_option_t   options;
+    bool (*custom_action)(bool activated, void *context);
+    void *context;
+    bool *enabled;
+} key_override_t;
+
+#define ko_make_with_layers_negmods_and_options(trigger_mods_, trigger_key, replacement_key, layer_mask, negative_mask, options_) \
+    ((const key_override_t){                                                                                                     \
+        .trigger_mods      = (trigger_mods_),                                                                                    \
+        .layers            = (layer_mask),                                                                                       \
+        .suppressed_mods   = (trigger_mods_),                                                                                    \
+        .options           = (options_),                                                                                         \
+        .negative_mod_mask = (negative_mask),                                                                                    \
+        .custom_action     = NULL,                                                                                               \
+        .context           = NULL,                                                                                               \
+        .trigger           = (trigger_key),                                                                                      \
+        .replacement       = (replacement_key),                                                                                  \
+        .enabled           = NULL,                                                                                               \
+    })
+#define ko_make_basic(trigger_mods, trigger_key, replacement_key) \
+    ko_make_with_layers_negmods_and_options(trigger_mods, trigger_key, replacement_key, ~0, 0, ko_options_default)
+
+uint16_t              key_override_count(void);
+const key_override_t *key_override_get(uint16_t key_override_idx);
+uint16_t              key_override_count_raw(void);
+const key_override_t *key_override_get_raw(uint16_t key_override_idx);
+void                  key_override_on(void);
+void                  key_override_off(void);
+bool                  key_override_is_enabled(void);
+
+
+// deferred exec
+
+typedef uint8_t deferred_token;
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+#define INVALID_DEFERRED_TOKEN 0
+#ifndef MAX_DEFERRED_EXECUTORS
+#    define MAX_DEFERRED_EXECUTORS 8
+#endif
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg);
+bool           extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+bool           cancel_deferred_exec(deferred_token token);
+
+
+// unicode
+
+enum unicode_input_modes {
+    UNICODE_MODE_MACOS,
+    UNICODE_MODE_LINUX,
+    UNICODE_MODE_WINDOWS,
+    UNICODE_MODE_BSD,
+    UNICODE_MODE_WINCOMPOSE,
+    UNICODE_MODE_EMACS,
+    UNICODE_MODE_COUNT,
+};
+
+void    set_unicode_input_mode(uint8_t mode);
+uint8_t get_unicode_input_mode(void);
+void    unicode_input_start(void);
+void    unicode_input_finish(void);
+void    register_hex32(uint32_t hex);
+void    register_unicode(uint32_t code_point);
+
+typedef enum { OS_UNSURE, OS_LINUX, OS_WINDOWS, OS_MACOS, OS_IOS } os_variant_t;
+
+bool process_detected_host_os_kb(os_variant_t detected_os);
+bool process_detected_host_os_user(os_variant_t detected_os);
+
+
+// pointing device
+
+void set_auto_mouse_layer(uint8_t layer);
+void set_auto_mouse_enable(bool enable);
+
+
+// the keymap hooks QMK calls
+
+void keyboard_post_init_user(void);
+void matrix_scan_user(void);
+void housekeeping_task_user(void);
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+void post_process_record_user(uint16_t keycode, keyrecord_t *record);
+void pointing_device_init_user(void);
@@ -0,0 +1,3 @@
+// raw_hid.h of the host QMK: everything is in quantum.h
+#pragma once
+#include "quantum.h"
@@ -0,0 +1,1596 @@
+/*
+This is the c file of the host QMK
+
+It runs Elil_50/keymap.c and its modules on the computer: the part of QMK they sit on is written again here,
+following QMK's own code (end of 2025) where the keymap can tell the difference:
+- the main loop: debounce, matrix_scan_user, one action_exec per changed key (a tick when none), combo_task,
+  deferred_exec_task and housekeeping_task_user, on a simulated clock advanced by one scan period per loop;
+- action_exec: pre_process_record_user and process_combo, then the tap-hold state machine of action_tapping.c;
+- process_record: caps word, process_record_user, the key overrides, then the basic actions on the HID report,
+  sent only when it changed, as send_keyboard_report does;
+- the layers with their source layer cache, the mods, deferred exec and the unicode input sequences;
+- a trackpoint that answers the register commands of trackpoint.c from a RAM register file, each byte taking
+  its time on the wire, and the steps of the driver init that bring it up from the pointing device task.
+Whatever the keymap does not use (one shot mods, tap dance, leader, ...) is left out.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "quantum.h"
+#include "debounce.h"
+#include "ps2.h"
+#include "drivers/sensors/ps2_mouse.h"
+#include "key_override_index.h"
+#include "host.h"
+
+#define WEAK __attribute__((weak))
+
+
+
+//    %-----------%
+//    |   CLOCK   |
+//    %-----------%
+
+static uint64_t now_us = 0;
+static uint32_t scan_us = 250; // about the matrix scan rate of the RP2040 split
+
+uint32_t timer_read32(void) {
+    return now_us / 1000;
+}
+
+uint16_t timer_read(void) {
+    return timer_read32();
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return TIMER_DIFF_32(timer_read32(), last);
+}
+
+uint64_t host_now_us(void) {
+    return now_us;
+}
+
+void host_set_scan_us(uint32_t us) {
+    scan_us = us ? us : 1;
+}
+
+
+
+//    %-------------%
+//    |   CONSOLE   |
+//    %-------------%
+
+// uint32_t is unsigned long on the keyboard and unsigned int here: drop the l of the keymap's %lu
+void uprintf(const char *format, ...) {
+    va_list     args;
+    char        host_format[256];
+    size_t      len = 0;
+    const char *c   = format;
+
+    while (*c && len < sizeof(host_format) - 1) {
+        host_format[len++] = *c;
+        if (*c++ != '%') continue;
+        while (*c && strchr("-+ #0123456789.l%", *c) && len < sizeof(host_format) - 1) {
+            if (*c == '%') {
+                host_format[len++] = *c++;
+                break;
+            }
+            if (*c != 'l') host_format[len++] = *c;
+            c++;
+        }
+    }
+    host_format[len] = '\0';
+
+    va_start(args, format);
+    vprintf(host_format, args);
+    va_end(args);
+}
+
+
+
+
+//    %------------%
+//    |   LAYERS   |
+//    %------------%
+
+layer_state_t layer_state         = 0;
+layer_state_t default_layer_state = 1;
+
+static uint8_t source_layer[MATRIX_ROWS][MATRIX_COLS]; // layer each held key was pressed on
+
+layer_state_t layer_state_set(layer_state_t state) {
+    layer_state = state;
+    return state;
+}
+
+void layer_on(uint8_t layer) {
+    layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+    layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+void layer_move(uint8_t layer) {
+    layer_state_set((layer_state_t)1 << layer);
+}
+
+void layer_invert(uint8_t layer) {
+    layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
+}
+
+bool layer_state_is(uint8_t layer) {
+    return layer_state ? (layer_state & ((layer_state_t)1 << layer)) != 0 : layer == 0;
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t layer = MAX_LAYER - 1; layer >= 0; layer--) {
+        if ((layers & ((layer_state_t)1 << layer)) && keymap_key_to_keycode(layer, key) != KC_TRNS) {
+            return layer;
+        }
+    }
+    return get_highest_layer(default_layer_state);
+}
+
+WEAK uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return keycode_at_keymap_location(layer, key.row, key.col);
+}
+
+WEAK uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keycode_at_keymap_location_raw(layer_num, row, column);
+}
+
+WEAK uint8_t keymap_layer_count(void) {
+    return keymap_layer_count_raw();
+}
+
+// QMK's get_event_keycode: a press resolves the layers and remembers where, its release reads it back
+static uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
+    if (event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) return KC_NO;
+
+    uint8_t layer;
+    if (event.pressed && update_layer_cache) {
+        layer = layer_switch_get_layer(event.key);
+        source_layer[event.key.row][event.key.col] = layer;
+    } else {
+        layer = source_layer[event.key.row][event.key.col];
+    }
+    return keymap_key_to_keycode(layer, event.key);
+}
+
+static uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
+    if (record->event.type == COMBO_EVENT) return record->keycode;
+    return get_event_keycode(record->event, update_layer_cache);
+}
+
+
+
+//    %----------------------%
+//    |   MODS AND REPORTS   |
+//    %----------------------%
+
+static uint8_t real_mods = 0;
+static uint8_t weak_mods = 0;
+static uint8_t weak_override_mods = 0; // mods of the replacement of an active key override
+static uint8_t suppressed_mods = 0;    // trigger mods hidden by an active key override
+
+static report_keyboard_t keyboard_report;
+static report_mouse_t    mouse_report;
+
+static host_report_hook_t report_hook = NULL;
+static uint32_t           keyboard_reports = 0;
+static uint32_t           mouse_reports = 0;
+static uint32_t           extra_reports = 0;
+
+static void driver_send_keyboard(report_keyboard_t *report) {
+    keyboard_reports++;
+    if (report_hook) report_hook(report);
+}
+
+static void driver_send_mouse(report_mouse_t *report) {
+    mouse_reports++;
+}
+
+static void driver_send_extra(report_extra_t *report) {
+    extra_reports++;
+}
+
+static host_driver_t  usb_driver = {NULL, driver_send_keyboard, NULL, driver_send_mouse, driver_send_extra};
+static host_driver_t *driver = &usb_driver;
+
+host_driver_t *host_get_driver(void) {
+    return driver;
+}
+
+void host_set_driver(host_driver_t *new_driver) {
+    driver = new_driver;
+}
+
+led_t host_keyboard_led_state(void) {
+    return (led_t){.raw = 0};
+}
+
+void host_set_report_hook(host_report_hook_t hook) {
+    report_hook = hook;
+}
+
+uint32_t host_keyboard_reports(void) {
+    return keyboard_reports;
+}
+
+uint32_t host_mouse_reports(void) {
+    return mouse_reports;
+}
+
+uint32_t host_extra_reports(void) {
+    return extra_reports;
+}
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+
+void add_mods(uint8_t mods) {
+    real_mods |= mods;
+}
+
+void del_mods(uint8_t mods) {
+    real_mods &= ~mods;
+}
+
+void set_mods(uint8_t mods) {
+    real_mods = mods;
+}
+
+void clear_mods(void) {
+    real_mods = 0;
+}
+
+uint8_t get_weak_mods(void) {
+    return weak_mods;
+}
+
+void add_weak_mods(uint8_t mods) {
+    weak_mods |= mods;
+}
+
+void del_weak_mods(uint8_t mods) {
+    weak_mods &= ~mods;
+}
+
+void clear_weak_mods(void) {
+    weak_mods = 0;
+}
+
+uint8_t get_oneshot_mods(void) {
+    return 0;
+}
+
+void send_keyboard_report(void) {
+    static report_keyboard_t last_report;
+
+    keyboard_report.mods = ((real_mods | weak_mods) & ~suppressed_mods) | weak_override_mods;
+    if (memcmp(&keyboard_report, &last_report, sizeof(keyboard_report)) != 0) {
+        last_report = keyboard_report;
+        driver->send_keyboard(&keyboard_report);
+    }
+}
+
+void register_mods(uint8_t mods) {
+    if (mods) {
+        add_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void unregister_mods(uint8_t mods) {
+    if (mods) {
+        del_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void register_weak_mods(uint8_t mods) {
+    if (mods) {
+        add_weak_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void unregister_weak_mods(uint8_t mods) {
+    if (mods) {
+        del_weak_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+static bool is_key_pressed(uint8_t code) {
+    for (uint8_t i = 0; i < sizeof(keyboard_report.keys); i++) {
+        if (keyboard_report.keys[i] == code) return true;
+    }
+    return false;
+}
+
+static void add_key(uint8_t code) {
+    for (uint8_t i = 0; i < sizeof(keyboard_report.keys); i++) {
+        if (keyboard_report.keys[i] == KC_NO) {
+            keyboard_report.keys[i] = code;
+            return;
+        }
+    }
+}
+
+static void del_key(uint8_t code) {
+    for (uint8_t i = 0; i < sizeof(keyboard_report.keys); i++) {
+        if (keyboard_report.keys[i] == code) keyboard_report.keys[i] = KC_NO;
+    }
+}
+
+void mousekey_on(uint8_t code) {
+    if (code >= MS_BTN1 && code <= MS_BTN5) mouse_report.buttons |= 1 << (code - MS_BTN1);
+}
+
+static void mousekey_off(uint8_t code) {
+    if (code >= MS_BTN1 && code <= MS_BTN5) mouse_report.buttons &= ~(1 << (code - MS_BTN1));
+}
+
+static void send_extra(uint16_t usage) {
+    report_extra_t report = {.report_id = 3, .usage = usage};
+    driver->send_extra(&report);
+}
+
+// 5 bit mods of a keycode to the 8 bit mods of the report
+static uint8_t mod_config(uint8_t mods) {
+    return mods & 0x10 ? (mods & 0x0F) << 4 : mods;
+}
+
+void register_code(uint8_t code) {
+    if (code == KC_NO) return;
+
+    if (code >= KC_A && code < KC_SYSTEM_POWER) {
+        if (is_key_pressed(code)) { // a new press of a key that is down, with other mods maybe
+            del_key(code);
+            send_keyboard_report();
+        }
+        add_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (code >= KC_SYSTEM_POWER && code <= KC_BRIGHTNESS_DOWN) {
+        send_extra(code);
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey_on(code);
+        driver->send_mouse(&mouse_report);
+    }
+}
+
+void unregister_code(uint8_t code) {
+    if (code == KC_NO) return;
+
+    if (code >= KC_A && code < KC_SYSTEM_POWER) {
+        del_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (code >= KC_SYSTEM_POWER && code <= KC_BRIGHTNESS_DOWN) {
+        send_extra(0);
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey_off(code);
+        driver->send_mouse(&mouse_report);
+    }
+}
+
+void tap_code(uint8_t code) {
+    register_code(code);
+    unregister_code(code);
+}
+
+void register_code16(uint16_t code) {
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        register_mods(mod_config(QK_MODS_GET_MODS(code)));
+    } else {
+        register_weak_mods(mod_config(QK_MODS_GET_MODS(code)));
+    }
+    register_code(code);
+}
+
+void unregister_code16(uint16_t code) {
+    unregister_code(code);
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        unregister_mods(mod_config(QK_MODS_GET_MODS(code)));
+    } else {
+        unregister_weak_mods(mod_config(QK_MODS_GET_MODS(code)));
+    }
+}
+
+void tap_code16(uint16_t code) {
+    register_code16(code);
+    unregister_code16(code);
+}
+
+void set_auto_mouse_layer(uint8_t layer) {}
+
+void set_auto_mouse_enable(bool enable) {}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {}
+
+
+
+//    %--------------%
+//    |   UNICODE    |
+//    %--------------%
+
+static uint8_t unicode_mode = UNICODE_MODE_LINUX;
+static uint8_t unicode_saved_mods;
+
+void set_unicode_input_mode(uint8_t mode) {
+    unicode_mode = mode;
+}
+
+uint8_t get_unicode_input_mode(void) {
+    return unicode_mode;
+}
+
+void unicode_input_start(void) {
+    unicode_saved_mods = get_mods();
+    clear_mods();
+    clear_weak_mods();
+
+    switch (unicode_mode) {
+        case UNICODE_MODE_MACOS:
+            register_code(KC_LEFT_ALT);
+            break;
+        case UNICODE_MODE_LINUX:
+            tap_code16(LCS(KC_U));
+            break;
+        case UNICODE_MODE_WINCOMPOSE:
+            tap_code(KC_RIGHT_ALT);
+            tap_code(KC_U);
+            break;
+    }
+}
+
+void unicode_input_finish(void) {
+    switch (unicode_mode) {
+        case UNICODE_MODE_MACOS:
+            unregister_code(KC_LEFT_ALT);
+            break;
+        case UNICODE_MODE_LINUX:
+            tap_code(KC_SPACE);
+            break;
+        case UNICODE_MODE_WINCOMPOSE:
+            tap_code(KC_ENTER);
+            break;
+    }
+    set_mods(unicode_saved_mods);
+}
+
+static uint8_t nibble_keycode(uint8_t nibble) {
+    return nibble == 0 ? KC_0 : nibble < 10 ? KC_1 + nibble - 1 : KC_A + nibble - 10;
+}
+
+void register_hex32(uint32_t hex) {
+    bool first_digit        = true;
+    bool needs_leading_zero = unicode_mode == UNICODE_MODE_WINCOMPOSE;
+
+    for (int8_t i = 7; i >= 0; i--) {
+        uint8_t digit = (hex >> (i * 4)) & 0xF;
+        if (first_digit && needs_leading_zero && digit > 9) {
+            tap_code(KC_0);
+        }
+        if (digit != 0 || !first_digit || i < 4) { // the last four digits always go out
+            tap_code(nibble_keycode(digit));
+            first_digit = false;
+        }
+    }
+}
+
+void register_unicode(uint32_t code_point) {
+    unicode_input_start();
+    register_hex32(code_point);
+    unicode_input_finish();
+}
+
+WEAK bool process_detected_host_os_user(os_variant_t detected_os) {
+    return true;
+}
+
+WEAK bool process_detected_host_os_kb(os_variant_t detected_os) {
+    return process_detected_host_os_user(detected_os);
+}
+
+
+
+//    %-------------------%
+//    |   DEFERRED EXEC   |
+//    %-------------------%
+
+typedef struct {
+    deferred_token         token;
+    uint32_t               trigger_time;
+    deferred_exec_callback callback;
+    void                  *cb_arg;
+} deferred_executor_t;
+
+static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS];
+static deferred_token      current_token = 0;
+
+static bool token_in_use(deferred_token token) {
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        if (executors[i].token == token) return true;
+    }
+    return false;
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    if (delay_ms == 0 || !callback) return INVALID_DEFERRED_TOKEN;
+
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        deferred_executor_t *entry = &executors[i];
+        if (entry->token != INVALID_DEFERRED_TOKEN) continue;
+
+        do {
+            current_token++;
+        } while (current_token == INVALID_DEFERRED_TOKEN || token_in_use(current_token));
+        entry->token        = current_token;
+        entry->trigger_time = timer_read32() + delay_ms;
+        entry->callback     = callback;
+        entry->cb_arg       = cb_arg;
+        return entry->token;
+    }
+    return INVALID_DEFERRED_TOKEN;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+    for (uint8_t i = 0; token != INVALID_DEFERRED_TOKEN && i < MAX_DEFERRED_EXECUTORS; i++) {
+        if (executors[i].token == token) {
+            executors[i].trigger_time = timer_read32() + delay_ms;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    for (uint8_t i = 0; token != INVALID_DEFERRED_TOKEN && i < MAX_DEFERRED_EXECUTORS; i++) {
+        if (executors[i].token == token) {
+            executors[i] = (deferred_executor_t){0};
+            return true;
+        }
+    }
+    return false;
+}
+
+static void deferred_exec_task(void) {
+    static uint32_t last_execution = 0;
+    uint32_t        now = timer_read32();
+
+    if ((int32_t)TIMER_DIFF_32(now, last_execution) <= 0) return; // once per ms
+    last_execution = now;
+
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        deferred_executor_t *entry = &executors[i];
+        if (entry->token == INVALID_DEFERRED_TOKEN || (int32_t)TIMER_DIFF_32(entry->trigger_time, now) > 0) continue;
+
+        uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+        if (delay_ms) {
+            entry->trigger_time += delay_ms;
+        } else {
+            entry->token = INVALID_DEFERRED_TOKEN;
+        }
+    }
+}
+
+
+
+//    %---------------%
+//    |   CAPS WORD   |
+//    %---------------%
+
+#define CAPS_WORD_IDLE_TIMEOUT 5000
+
+static bool     caps_word = false;
+static uint16_t caps_word_time;
+
+void caps_word_on(void) {
+    caps_word      = true;
+    caps_word_time = timer_read();
+}
+
+void caps_word_off(void) {
+    if (!caps_word) return;
+    caps_word = false;
+    unregister_weak_mods(MOD_MASK_SHIFT);
+}
+
+bool is_caps_word_on(void) {
+    return caps_word;
+}
+
+// the default caps_word_press_user: letters shifted, digits, backspace, delete and - keep it on
+static bool process_caps_word(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == CW_TOGG && record->event.pressed) {
+        caps_word ? caps_word_off() : caps_word_on();
+        return false;
+    }
+    if (!caps_word || !record->event.pressed) return true;
+
+    caps_word_time = timer_read();
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        if (!record->tap.count) return true;
+        keycode &= 0xFF;
+    }
+    if (IS_MODIFIER_KEYCODE(keycode)) return true;
+
+    if (keycode >= KC_A && keycode <= KC_Z) {
+        add_weak_mods(MOD_BIT(KC_LSFT));
+    } else if (!((keycode >= KC_1 && keycode <= KC_0) || keycode == KC_BSPC || keycode == KC_DEL || keycode == KC_MINS || keycode == KC_UNDS)) {
+        caps_word_off();
+    }
+    return true;
+}
+
+static void caps_word_task(void) {
+    if (caps_word && timer_elapsed(caps_word_time) >= CAPS_WORD_IDLE_TIMEOUT) caps_word_off();
+}
+
+
+
+//    %-----------%
+//    |   COMBO   |
+//    %-----------%
+
+// QMK's process_combo.c, without the per-combo options the keymap does not use
+
+#define COMBO_KEY_BUFFER_LENGTH 8
+#define COMBO_BUFFER_LENGTH 4
+
+typedef struct {
+    keyrecord_t record;
+    uint16_t    combo_index;
+    uint16_t    keycode;
+} queued_record_t;
+
+static queued_record_t key_buffer[COMBO_KEY_BUFFER_LENGTH];
+static uint8_t         key_buffer_size = 0;
+static uint16_t        combo_buffer[COMBO_BUFFER_LENGTH];
+static uint8_t         combo_buffer_write = 0;
+static uint8_t         combo_buffer_read = 0;
+static uint16_t        combo_timer = 0;
+static uint16_t        longest_term = 0;
+static bool            combo_enabled = true;
+
+#define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
+#define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << (key_count)) - 1) == (state))
+#define ONLY_ONE_KEY_IS_DOWN(state) !((state) & ((state) - 1))
+#define KEY_NOT_YET_RELEASED(state, key_index) ((1 << (key_index)) & (state))
+
+void action_tapping_process(keyrecord_t record);
+
+WEAK uint16_t combo_count(void) {
+    return combo_count_raw();
+}
+
+WEAK combo_t *combo_get(uint16_t combo_idx) {
+    return combo_get_raw(combo_idx);
+}
+
+static void release_combo(combo_t *combo) {
+    if (combo->keycode) {
+        keyrecord_t record = {
+            .event   = MAKE_EVENT(KEYLOC_COMBO, KEYLOC_COMBO, false, COMBO_EVENT),
+            .keycode = combo->keycode,
+        };
+        action_tapping_process(record);
+    }
+    combo->active = false;
+}
+
+static void clear_combos(void) {
+    longest_term = 0;
+    for (uint16_t index = 0; index < combo_count(); index++) {
+        combo_t *combo = combo_get(index);
+        if (!combo->active) {
+            combo->disabled = false;
+            combo->state    = 0;
+        }
+    }
+}
+
+static void dump_key_buffer(void) {
+    static uint8_t key_buffer_next = 0; // a nested call goes on after the record that made it
+
+    for (uint8_t i = key_buffer_next; i < key_buffer_size; i++) {
+        key_buffer_next     = i + 1;
+        keyrecord_t *record = &key_buffer[i].record;
+
+        if (IS_NOEVENT(record->event)) continue;
+        action_tapping_process(*record);
+        record->event.type = TICK_EVENT;
+    }
+    key_buffer_next = key_buffer_size = 0;
+}
+
+static void find_key_index_and_count(const uint16_t *keys, uint16_t keycode, uint16_t *key_index, uint8_t *key_count) {
+    while (true) {
+        uint16_t key = pgm_read_word(&keys[*key_count]);
+        if (key == keycode) *key_index = *key_count;
+        if (key == COMBO_END) break;
+        (*key_count)++;
+    }
+}
+
+static void drop_combo_from_buffer(uint16_t combo_index) {
+    for (uint8_t i = combo_buffer_read; i != combo_buffer_write; INCREMENT_MOD(i)) {
+        if (combo_buffer[i] == combo_index) {
+            combo_get(combo_index)->disabled = true;
+            if (i == combo_buffer_read) INCREMENT_MOD(combo_buffer_read);
+            break;
+        }
+    }
+}
+
+static void apply_combo(uint16_t combo_index, combo_t *combo) {
+    if (combo->disabled) return;
+
+    uint8_t state = 0;
+    for (uint8_t i = 0; i < key_buffer_size; i++) {
+        queued_record_t *qrecord   = &key_buffer[i];
+        keyrecord_t     *record    = &qrecord->record;
+        uint8_t          key_count = 0;
+        uint16_t         key_index = -1;
+
+        find_key_index_and_count(combo->keys, qrecord->keycode, &key_index, &key_count);
+        if ((int16_t)key_index == -1) continue;
+
+        state |= 1 << key_index;
+        if (ALL_COMBO_KEYS_ARE_DOWN(state, key_count)) { // the last key of the chord fires the combo
+            record->keycode     = combo->keycode;
+            record->event.type  = COMBO_EVENT;
+            record->event.key   = MAKE_KEYPOS(KEYLOC_COMBO, KEYLOC_COMBO);
+            qrecord->combo_index = combo_index;
+            combo->active        = true;
+            break;
+        }
+        record->event.type = TICK_EVENT; // the others are dropped
+    }
+    drop_combo_from_buffer(combo_index);
+}
+
+static void apply_combos(void) {
+    for (uint8_t i = combo_buffer_read; i != combo_buffer_write; INCREMENT_MOD(i)) {
+        apply_combo(combo_buffer[i], combo_get(combo_buffer[i]));
+    }
+    dump_key_buffer();
+    clear_combos();
+}
+
+// the combo of the two that should be dropped: the shorter one, or combo1 for the same length
+static combo_t *overlaps(combo_t *combo1, combo_t *combo2) {
+    uint8_t  idx1 = 0, idx2 = 0;
+    uint16_t key1, key2;
+    bool     overlap = false;
+
+    while ((key1 = pgm_read_word(&combo1->keys[idx1])) != COMBO_END) {
+        idx2 = 0;
+        while ((key2 = pgm_read_word(&combo2->keys[idx2])) != COMBO_END) {
+            if (key1 == key2) overlap = true;
+            idx2++;
+        }
+        idx1++;
+    }
+    if (!overlap) return NULL;
+    return idx2 < idx1 ? combo2 : combo1;
+}
+
+static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
+    if ((int16_t)key_index == -1) return false;
+
+    bool key_is_part_of_combo = !combo->disabled && combo_enabled;
+
+    if (record->event.pressed && key_is_part_of_combo) {
+        if (!combo->active) {
+            combo->state |= 1 << key_index;
+            if (longest_term < COMBO_TERM) longest_term = COMBO_TERM;
+        }
+        if (ALL_COMBO_KEYS_ARE_DOWN(combo->state, key_count)) {
+            if (combo_timer && timer_elapsed(combo_timer) > COMBO_TERM) {
+                combo->disabled = true; // completed too late
+                return true;
+            }
+
+            combo_t *drop = NULL;
+            for (uint8_t i = combo_buffer_read; i != combo_buffer_write; INCREMENT_MOD(i)) {
+                combo_t *buffered = combo_get(combo_buffer[i]);
+                if ((drop = overlaps(buffered, combo))) {
+                    drop->disabled = true;
+                    if (drop == combo) break;
+                    if (i == combo_buffer_read && drop == buffered) INCREMENT_MOD(combo_buffer_read);
+                }
+            }
+            if (drop != combo) {
+                combo_buffer[combo_buffer_write] = combo_index;
+                INCREMENT_MOD(combo_buffer_write);
+                longest_term = COMBO_TERM;
+            }
+        }
+    } else {
+        if (!combo->active && ALL_COMBO_KEYS_ARE_DOWN(combo->state, key_count)) {
+            if (combo->disabled) { // released before it was applied, and not tappable
+                drop_combo_from_buffer(combo_index);
+                key_is_part_of_combo = false;
+            }
+        } else if (combo->active && ONLY_ONE_KEY_IS_DOWN(combo->state) && KEY_NOT_YET_RELEASED(combo->state, key_index)) {
+            release_combo(combo); // the last key of an active combo
+            key_is_part_of_combo = true;
+        } else if (combo->active && KEY_NOT_YET_RELEASED(combo->state, key_index)) {
+            key_is_part_of_combo = true;
+        } else {
+            key_is_part_of_combo = false; // a key of an incomplete combo
+        }
+        combo->state &= ~(1 << key_index);
+    }
+    return key_is_part_of_combo;
+}
+
+bool process_combo(uint16_t keycode, keyrecord_t *record) {
+    bool is_combo_key = false;
+
+    if (!combo_enabled) return true;
+
+    for (uint16_t idx = 0; idx < combo_count(); idx++) {
+        is_combo_key |= process_single_combo(combo_get(idx), keycode, record, idx);
+    }
+
+    if (record->event.pressed && is_combo_key) {
+        combo_timer = timer_read();
+        if (key_buffer_size < COMBO_KEY_BUFFER_LENGTH) {
+            key_buffer[key_buffer_size++] = (queued_record_t){.record = *record, .keycode = keycode, .combo_index = -1};
+        }
+    } else if (combo_buffer_read != combo_buffer_write) {
+        apply_combos(); // a combo is ready
+    } else {
+        dump_key_buffer();
+        combo_timer = 0;
+        clear_combos();
+    }
+    return !is_combo_key;
+}
+
+static void combo_task(void) {
+    if (!combo_enabled) return;
+
+    if (combo_timer && timer_elapsed(combo_timer) > longest_term) {
+        if (combo_buffer_read != combo_buffer_write) {
+            apply_combos();
+            longest_term = 0;
+        } else {
+            dump_key_buffer();
+            clear_combos();
+        }
+        combo_timer = 0;
+    }
+}
+
+void combo_enable(void) {
+    combo_enabled = true;
+}
+
+void combo_disable(void) {
+    combo_timer       = 0;
+    combo_enabled     = false;
+    combo_buffer_read = combo_buffer_write;
+    clear_combos();
+    dump_key_buffer();
+}
+
+bool is_combo_enabled(void) {
+    return combo_enabled;
+}
+
+
+
+//    %-------------------%
+//    |   KEY OVERRIDES   |
+//    %-------------------%
+
+// QMK's process_key_override.c, without the repeat of the trigger after the override ends
+
+static const key_override_t *active_override = NULL;
+static bool                  active_override_trigger_is_down = false;
+static uint16_t              registered_replacement = KC_NO;
+static uint16_t              last_key_down = KC_NO;
+static bool                  key_override_enabled = true;
+static const key_override_t *activated_override = NULL; // by the event being processed
+static uint32_t              overrides_fired = 0;
+static uint32_t              overrides_mispredicted = 0;
+
+WEAK uint16_t key_override_count(void) {
+    return key_override_count_raw();
+}
+
+WEAK const key_override_t *key_override_get(uint16_t key_override_idx) {
+    return key_override_get_raw(key_override_idx);
+}
+
+void key_override_on(void) {
+    key_override_enabled = true;
+}
+
+void key_override_off(void) {
+    key_override_enabled = false;
+}
+
+bool key_override_is_enabled(void) {
+    return key_override_enabled;
+}
+
+static bool override_mods_match(const key_override_t *override, uint8_t mods) {
+    if (mods & override->negative_mod_mask) return false;
+    if (override->options & ko_option_one_mod) return mods & override->trigger_mods;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t side_mods = 0x11 << i;
+        if ((override->trigger_mods & side_mods) && !(mods & side_mods)) return false;
+    }
+    return true;
+}
+
+static void clear_active_override(void) {
+    if (active_override == NULL) return;
+
+    if (registered_replacement != KC_NO) {
+        unregister_code(registered_replacement);
+        registered_replacement = KC_NO;
+    }
+    if (active_override->custom_action != NULL) {
+        active_override->custom_action(false, active_override->context);
+    }
+    active_override                 = NULL;
+    active_override_trigger_is_down = false;
+    weak_override_mods              = 0;
+    suppressed_mods                 = 0;
+    send_keyboard_report();
+}
+
+static bool try_activating_override(uint16_t keycode, uint8_t layer, bool key_down, bool is_mod, uint8_t mods) {
+    for (uint16_t i = 0; i < key_override_count(); i++) {
+        const key_override_t *override = key_override_get(i);
+        if (override == NULL) continue;
+
+        if (!(override->layers & ((layer_state_t)1 << layer))) continue;
+        if (key_down) {
+            if (!(override->options & (is_mod ? ko_option_activation_required_mod_down : ko_option_activation_trigger_down))) continue;
+        } else if (!(override->options & ko_option_activation_negative_mod_up)) {
+            continue;
+        }
+        if (override->trigger != (is_mod || !key_down ? last_key_down : keycode)) continue;
+        if (override->trigger == KC_NO || !override_mods_match(override, mods)) continue;
+        if (override->enabled != NULL && !*override->enabled) continue;
+
+        clear_active_override();
+        active_override                 = override;
+        activated_override              = override;
+        active_override_trigger_is_down = true;
+        suppressed_mods                 = override->suppressed_mods;
+
+        if (is_mod || !key_down) {
+            unregister_code(override->trigger); // the trigger was registered before the mods changed
+        }
+        if (override->custom_action == NULL || override->custom_action(true, override->context)) {
+            uint16_t replacement = override->replacement;
+            weak_override_mods   = mod_config(QK_MODS_GET_MODS(replacement));
+            if ((replacement & 0xFF) != KC_NO) {
+                registered_replacement = replacement & 0xFF;
+                register_code(registered_replacement);
+            }
+        }
+        send_keyboard_report();
+        return true;
+    }
+    return false;
+}
+
+static bool process_key_override(uint16_t keycode, keyrecord_t *record) {
+    bool key_down = record->event.pressed;
+    bool is_mod   = IS_MODIFIER_KEYCODE(keycode);
+
+    if (!key_override_enabled) return true;
+
+    uint8_t mods = get_mods();
+    if (is_mod) { // the mod of this event is registered after the overrides
+        mods = key_down ? mods | MOD_BIT(keycode) : mods & ~MOD_BIT(keycode);
+    } else if (key_down) {
+        last_key_down = keycode;
+        if (active_override != NULL && active_override->trigger != keycode &&
+            !(active_override->options & ko_option_no_unregister_on_other_key_down)) {
+            clear_active_override();
+        }
+    } else if (keycode == last_key_down) {
+        last_key_down = KC_NO;
+    }
+
+    if (!key_down && active_override != NULL && active_override->trigger == keycode) {
+        active_override_trigger_is_down = false;
+        clear_active_override();
+        return false; // the release of the trigger of an override
+    }
+
+    if (active_override != NULL && !override_mods_match(active_override, mods)) {
+        clear_active_override();
+    }
+    if (active_override == NULL && (key_down || is_mod)) {
+        uint8_t layer = get_highest_layer(layer_state | default_layer_state);
+        if (try_activating_override(keycode, layer, key_down, is_mod, mods)) return is_mod;
+    }
+    return true;
+}
+
+
+
+//    %-------------%
+//    |   ACTIONS   |
+//    %-------------%
+
+static uint8_t retro_tapping_counter = 0;
+
+WEAK bool get_retro_tapping(uint16_t keycode, keyrecord_t *record) {
+    return false;
+}
+
+WEAK uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    return QUICK_TAP_TERM;
+}
+
+WEAK void post_process_record_user(uint16_t keycode, keyrecord_t *record) {}
+
+WEAK bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+static bool is_tap_keycode(uint16_t keycode) {
+    return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+}
+
+// process_action for the keycodes of the keymap
+static void process_action(keyrecord_t *record, uint16_t keycode) {
+    bool    pressed   = record->event.pressed;
+    uint8_t tap_count = record->tap.count;
+
+    if (IS_QK_MODS(keycode)) {
+        uint8_t mods = mod_config(QK_MODS_GET_MODS(keycode));
+        uint8_t code = QK_MODS_GET_BASIC_KEYCODE(keycode);
+        bool    real = IS_MODIFIER_KEYCODE(code) || code == KC_NO;
+        if (pressed) {
+            real ? add_mods(mods) : add_weak_mods(mods);
+            send_keyboard_report();
+            register_code(code);
+        } else {
+            unregister_code(code);
+            real ? del_mods(mods) : del_weak_mods(mods);
+            send_keyboard_report();
+        }
+    } else if (IS_QK_MOD_TAP(keycode)) {
+        uint8_t mods = mod_config(QK_MOD_TAP_GET_MODS(keycode));
+        uint8_t code = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+        if (pressed) {
+            tap_count ? register_code(code) : register_mods(mods);
+        } else {
+            tap_count ? unregister_code(code) : unregister_mods(mods);
+        }
+    } else if (IS_QK_LAYER_TAP(keycode)) {
+        uint8_t layer = QK_LAYER_TAP_GET_LAYER(keycode);
+        uint8_t code  = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+        if (pressed) {
+            tap_count ? register_code(code) : layer_on(layer);
+        } else {
+            tap_count ? unregister_code(code) : layer_off(layer);
+        }
+    } else if (IS_QK_TOGGLE_LAYER(keycode)) {
+        if (!pressed) layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+    } else if (keycode <= 0xFF) {
+        pressed ? register_code(keycode) : unregister_code(keycode);
+    }
+
+    // retro tapping: a mod-tap pressed and released with no other event in between taps its key
+    if (!is_tap_keycode(keycode)) {
+        retro_tapping_counter = 0;
+    } else if (!pressed && !tap_count) {
+        if (retro_tapping_counter == 2 && get_retro_tapping(keycode, record)) {
+            tap_code(keycode & 0xFF);
+        }
+        retro_tapping_counter = 0;
+    } else if (tap_count) {
+        retro_tapping_counter = 0;
+    }
+}
+
+static void process_record_quantum(uint16_t keycode, keyrecord_t *record) {
+    if (!(process_caps_word(keycode, record) && process_record_user(keycode, record) && process_key_override(keycode, record))) {
+        return;
+    }
+    process_action(record, record->event.type == COMBO_EVENT ? record->keycode : get_event_keycode(record->event, false));
+    post_process_record_user(keycode, record);
+}
+
+static void process_record(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) return;
+
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // the override the keymap is told a press fires, against the one the overrides activate on it
+    bool                  trigger_down = record->event.pressed && !IS_MODIFIER_KEYCODE(keycode);
+    const key_override_t *predicted    = trigger_down ? key_override_index_firing(keycode) : NULL;
+    activated_override                 = NULL;
+    process_record_quantum(keycode, record);
+    if (trigger_down) {
+        overrides_fired += activated_override != NULL;
+        overrides_mispredicted += activated_override != predicted;
+    }
+}
+
+uint32_t host_overrides_fired(void) {
+    return overrides_fired;
+}
+
+uint32_t host_overrides_mispredicted(void) {
+    return overrides_mispredicted;
+}
+
+
+
+//    %--------------%
+//    |   TAP-HOLD   |
+//    %--------------%
+
+// QMK's action_tapping.c, with the per key hold on other key press and permissive hold of config.h
+
+#define WAITING_BUFFER_SIZE 8
+
+static keyrecord_t tapping_key = {0};
+static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE];
+static uint8_t     waiting_buffer_head = 0;
+static uint8_t     waiting_buffer_tail = 0;
+
+#define KEYEQ(a, b) ((a).row == (b).row && (a).col == (b).col)
+#define IS_TAPPING_RECORD(r) \
+    (KEYEQ((r)->event.key, tapping_key.event.key) && (r)->event.type == tapping_key.event.type && \
+     ((r)->event.type != COMBO_EVENT || (r)->keycode == tapping_key.keycode))
+#define TAPPING_KEYCODE get_record_keycode(&tapping_key, false)
+#define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16((e).time, tapping_key.event.time) < GET_TAPPING_TERM(TAPPING_KEYCODE, &tapping_key))
+#define WITHIN_QUICK_TAP_TERM(e) (TIMER_DIFF_16((e).time, tapping_key.event.time) < GET_QUICK_TAP_TERM(TAPPING_KEYCODE, &tapping_key))
+
+static bool is_tap_record(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) return false;
+    return is_tap_keycode(get_record_keycode(record, false));
+}
+
+static bool waiting_buffer_enq(keyrecord_t record) {
+    if (IS_NOEVENT(record.event)) return true;
+    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) return false;
+
+    waiting_buffer[waiting_buffer_head] = record;
+    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    return true;
+}
+
+static bool waiting_buffer_typed(keyevent_t event) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) return true;
+    }
+    return false;
+}
+
+// a tap key pressed again: its release may already be waiting
+static void waiting_buffer_scan_tap(void) {
+    if (tapping_key.tap.count > 0 || !tapping_key.event.pressed) return;
+
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        keyrecord_t *candidate = &waiting_buffer[i];
+        if (IS_EVENT(candidate->event) && KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed &&
+            WITHIN_TAPPING_TERM(candidate->event)) {
+            tapping_key.tap.count = 1;
+            candidate->tap.count  = 1;
+            process_record(&tapping_key);
+            return;
+        }
+    }
+}
+
+// a release that must wait for the tapping key: a mod or a layer of a key pressed before it
+static bool hold_release(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, false);
+    if (IS_MODIFIER_KEYCODE(keycode)) return true;
+    if (IS_QK_MODS(keycode)) return !QK_MODS_GET_BASIC_KEYCODE(keycode) || IS_MODIFIER_KEYCODE(QK_MODS_GET_BASIC_KEYCODE(keycode));
+    if (IS_QK_MOD_TAP(keycode)) return !record->tap.count;
+    return IS_QK_LAYER_TAP(keycode);
+}
+
+static void release_last_tap(keyevent_t event) {
+    if (tapping_key.tap.count > 1) {
+        process_record(&(keyrecord_t){
+            .tap     = tapping_key.tap,
+            .event   = {.key = tapping_key.event.key, .time = event.time, .pressed = false, .type = tapping_key.event.type},
+            .keycode = tapping_key.keycode,
+        });
+    }
+}
+
+static bool process_tapping(keyrecord_t *keyp) {
+    const keyevent_t event = keyp->event;
+
+    if (IS_NOEVENT(tapping_key.event)) {
+        if (!IS_EVENT(event)) {
+        } else if (event.pressed && is_tap_record(keyp)) {
+            tapping_key = *keyp; // start
+            waiting_buffer_scan_tap();
+        } else {
+            process_record(keyp);
+        }
+        return true;
+    }
+
+    if (tapping_key.event.pressed) {
+        if (WITHIN_TAPPING_TERM(event)) {
+            if (IS_NOEVENT(event)) return true;
+
+            if (tapping_key.tap.count == 0) {
+                if (IS_TAPPING_RECORD(keyp) && !event.pressed) { // first tap
+                    tapping_key.tap.count = 1;
+                    process_record(&tapping_key);
+                    keyp->tap = tapping_key.tap;
+                    return false;
+                }
+                if (!event.pressed && waiting_buffer_typed(event)) { // permissive hold: a key typed within the term
+                    process_record(&tapping_key);
+                    tapping_key = (keyrecord_t){0};
+                    return false;
+                }
+                if (!event.pressed && !waiting_buffer_typed(event)) { // the release of a key pressed before
+                    if (hold_release(keyp)) return false;
+                    process_record(keyp);
+                    return true;
+                }
+                if (event.pressed) {
+                    tapping_key.tap.interrupted = true;
+                    if (get_hold_on_other_key_press(TAPPING_KEYCODE, &tapping_key)) {
+                        process_record(&tapping_key);
+                        tapping_key = (keyrecord_t){0};
+                    }
+                }
+                return false;
+            }
+
+            if (IS_TAPPING_RECORD(keyp) && !event.pressed) { // tap release
+                keyp->tap = tapping_key.tap;
+                process_record(keyp);
+                tapping_key = *keyp;
+                return true;
+            }
+            if (is_tap_record(keyp) && event.pressed) {
+                release_last_tap(event);
+                tapping_key = *keyp;
+                waiting_buffer_scan_tap();
+                return true;
+            }
+            process_record(keyp);
+            return true;
+        }
+
+        // after the tapping term
+        if (tapping_key.tap.count == 0) { // a hold
+            process_record(&tapping_key);
+            tapping_key = (keyrecord_t){0};
+            return false;
+        }
+        if (IS_NOEVENT(event)) return true;
+        if (IS_TAPPING_RECORD(keyp) && !event.pressed) {
+            keyp->tap = tapping_key.tap;
+            process_record(keyp);
+            tapping_key = (keyrecord_t){0};
+            return true;
+        }
+        if (is_tap_record(keyp) && event.pressed) {
+            release_last_tap(event);
+            tapping_key = *keyp;
+            waiting_buffer_scan_tap();
+            return true;
+        }
+        process_record(keyp);
+        return true;
+    }
+
+    // the tapping key is released
+    if (WITHIN_TAPPING_TERM(event)) {
+        if (IS_NOEVENT(event)) return true;
+
+        if (!event.pressed) {
+            process_record(keyp);
+            return true;
+        }
+        if (IS_TAPPING_RECORD(keyp)) {
+            if (WITHIN_QUICK_TAP_TERM(event) && !tapping_key.tap.interrupted && tapping_key.tap.count > 0) { // sequential tap
+                keyp->tap = tapping_key.tap;
+                if (keyp->tap.count < 15) keyp->tap.count++;
+                process_record(keyp);
+            }
+            tapping_key = *keyp;
+            return true;
+        }
+        if (is_tap_record(keyp)) {
+            tapping_key = *keyp;
+            waiting_buffer_scan_tap();
+            return true;
+        }
+        tapping_key.tap.interrupted = true;
+        process_record(keyp);
+        return true;
+    }
+    tapping_key = (keyrecord_t){0}; // no sequential tap anymore
+    return false;
+}
+
+void action_tapping_process(keyrecord_t record) {
+    if (!process_tapping(&record) && !waiting_buffer_enq(record)) {
+        waiting_buffer_head = waiting_buffer_tail = 0;
+        tapping_key                               = (keyrecord_t){0};
+    }
+
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+        if (!process_tapping(&waiting_buffer[waiting_buffer_tail])) break;
+    }
+}
+
+void action_exec(keyevent_t event) {
+    if (IS_EVENT(event)) retro_tapping_counter++;
+    if (event.pressed) clear_weak_mods();
+
+    keyrecord_t record = {.event = event};
+    if (IS_NOEVENT(record.event)) {
+        action_tapping_process(record);
+        return;
+    }
+
+    uint16_t keycode = get_record_keycode(&record, true);
+    if (pre_process_record_user(keycode, &record) && process_combo(keycode, &record)) {
+        action_tapping_process(record);
+    }
+}
+
+
+
+//    %------------%
+//    |   MATRIX   |
+//    %------------%
+
+static matrix_row_t raw_matrix[MATRIX_ROWS];
+static matrix_row_t matrix[MATRIX_ROWS];
+static matrix_row_t previous_raw[MATRIX_ROWS];
+static matrix_row_t previous_matrix[MATRIX_ROWS];
+
+matrix_row_t matrix_get_row(uint8_t row) {
+    return matrix[row];
+}
+
+bool matrix_is_on(uint8_t row, uint8_t col) {
+    return matrix[row] & ((matrix_row_t)1 << col);
+}
+
+void host_key(uint8_t row, uint8_t col, bool closed) {
+    if (closed) {
+        raw_matrix[row] |= (matrix_row_t)1 << col;
+    } else {
+        raw_matrix[row] &= ~((matrix_row_t)1 << col);
+    }
+}
+
+static void ps2_mouse_task(void);
+
+// one pass of QMK's main loop
+void host_scan(void) {
+    static uint16_t last_tick     = 0;
+    static uint32_t last_pointing = 0;
+
+    now_us += scan_us;
+
+    bool changed = memcmp(raw_matrix, previous_raw, sizeof(raw_matrix)) != 0;
+    memcpy(previous_raw, raw_matrix, sizeof(raw_matrix));
+    debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    matrix_scan_user();
+
+    bool event = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t changes = matrix[row] ^ previous_matrix[row];
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t mask = (matrix_row_t)1 << col;
+            if (!(changes & mask)) continue;
+
+            event = true;
+            action_exec(MAKE_KEYEVENT(row, col, matrix[row] & mask));
+            previous_matrix[row] ^= mask;
+        }
+    }
+    if (!event && timer_read() != last_tick) { // a tick at most once per ms
+        last_tick = timer_read();
+        action_exec((keyevent_t){.type = TICK_EVENT, .time = timer_read() | 1});
+    }
+
+    combo_task();
+    deferred_exec_task();
+    caps_word_task();
+    if (timer_read32() != last_pointing) { // the pointing device task, once per ms
+        last_pointing = timer_read32();
+        ps2_mouse_task();
+    }
+    housekeeping_task_user();
+}
+
+void host_run_until(uint64_t us) {
+    while (now_us < us) {
+        host_scan();
+    }
+}
+
+
+
+//    %----------------%
+//    |   TRACKPOINT   |
+//    %----------------%
+
+// a trackpoint on the PS/2 wire: every byte is acknowledged, E2 80 addr reads and E2 81 addr value writes its RAM
+
+#ifndef PS2_MOUSE_INIT_DELAY
+#    define PS2_MOUSE_INIT_DELAY 1000
+#endif
+#define PS2_SEND_US 2000 // a byte out and its acknowledge back, 11 bits each at about 10 kHz, the caller waits
+#define PS2_RECV_US 1100 // a byte of an answer
+
+// the steps of the driver init, one per pointing device task: see ps2_mouse_init_step() in the patch
+enum { TP_POWER_UP, TP_BAT, TP_DEVICE_ID, TP_CONFIGURE, TP_USER, TP_READY };
+
+uint8_t ps2_error = PS2_ERR_NONE;
+
+static uint8_t  tp_ram[256];
+static uint8_t  tp_command[4];
+static uint8_t  tp_command_len = 0;
+static uint8_t  tp_response = 0;
+static uint8_t  tp_state = TP_POWER_UP;
+static uint32_t tp_ready_time = 0;
+static uint32_t tp_task_max_us = 0; // longest pointing device task of the init
+
+void ps2_host_init(void) {}
+
+uint8_t ps2_host_send(uint8_t data) {
+    now_us += PS2_SEND_US;
+    ps2_error = PS2_ERR_NONE;
+    if (tp_command_len == 0 && data != 0xE2) return PS2_ACK; // a mouse command: nothing to simulate
+
+    tp_command[tp_command_len++] = data;
+    if (tp_command_len == 3 && tp_command[1] == 0x80) {
+        tp_response    = tp_ram[tp_command[2]];
+        tp_command_len = 0;
+    } else if (tp_command_len == 4) {
+        if (tp_command[1] == 0x81) tp_ram[tp_command[2]] = tp_command[3];
+        tp_command_len = 0;
+    }
+    return PS2_ACK;
+}
+
+uint8_t ps2_host_recv_response(void) {
+    now_us += PS2_RECV_US;
+    return tp_response;
+}
+
+uint8_t ps2_host_recv(void) {
+    return 0;
+}
+
+void ps2_mouse_enable_data_reporting(void) {
+    ps2_host_send(0xF4);
+}
+
+void ps2_mouse_disable_data_reporting(void) {
+    ps2_host_send(0xF5);
+}
+
+void ps2_mouse_poll_now(void) {}
+
+uint16_t ps2_mouse_resync_count(void) {
+    return 0;
+}
+
+uint16_t ps2_mouse_error_count(void) {
+    return 0;
+}
+
+uint16_t ps2_mouse_recovery_count(void) {
+    return 0;
+}
+
+bool ps2_mouse_is_ready(void) {
+    return tp_state == TP_READY;
+}
+
+uint32_t ps2_mouse_ready_time(void) {
+    return tp_ready_time;
+}
+
+uint32_t host_ps2_task_max_us(void) {
+    return tp_task_max_us;
+}
+
+WEAK bool ps2_mouse_configure_user(void) {
+    return true;
+}
+
+WEAK void ps2_mouse_ready_user(void) {}
+
+// the init of the driver with the options of config.h: stream mode, no wheel, no scaling, the default sample rate
+static void ps2_mouse_task(void) {
+    uint64_t start = now_us;
+
+    switch (tp_state) {
+        case TP_POWER_UP:
+            if (timer_read32() < PS2_MOUSE_INIT_DELAY) return;
+            ps2_host_send(0xFF); // reset
+            tp_state = TP_BAT;
+            break;
+        case TP_BAT: // the trackpoint answers its self test and device ID at once
+        case TP_DEVICE_ID:
+            ps2_host_recv_response();
+            tp_state++;
+            break;
+        case TP_CONFIGURE:
+            ps2_host_send(0xEA); // stream mode, the only command of ps2_mouse_commands
+            tp_state = TP_USER;
+            break;
+        case TP_USER:
+            if (!ps2_mouse_configure_user()) break;
+            ps2_mouse_enable_data_reporting();
+            tp_state      = TP_READY;
+            tp_ready_time = timer_read32();
+            ps2_mouse_ready_user();
+            break;
+        case TP_READY:
+            return;
+    }
+    if (now_us - start > tp_task_max_us) tp_task_max_us = now_us - start;
+}
+
+WEAK void pointing_device_init_user(void) {}
+
+
+
+//    %----------%
+//    |   BOOT   |
+//    %----------%
+
+void host_init(void) {
+    tp_ram[0x4A] = 0x59; // the register defaults the keymap comments list
+    tp_ram[0x60] = 0x61;
+    tp_ram[0x4D] = 0x06;
+    tp_ram[0x5C] = 0x08;
+
+    debounce_init(MATRIX_ROWS);
+    keyboard_post_init_user();
+    process_detected_host_os_kb(OS_LINUX);
+    pointing_device_init_user(); // the trackpoint comes up later, from the pointing device task
+}
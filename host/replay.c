@@ -0,0 +1,570 @@
+/*
+This is the c file of the replay harness
+
+It types on the keymap built for the host, with the timing of a person, and prints what the keymap measured
+with MY_LATENCY_STATS_ENABLE: the same lines LAT_DUMP prints in "qmk console" on the keyboard.
+usage: ./replay [--presses N] [--seed N] [--scan-us us] [--unicode linux|macos|wincompose] [--trace FILE] [--game on|off] [--glyphs]
+
+Without --trace it types a built-in text: a press every 40 - 200 ms held for 30 - 150 ms, so letters roll,
+the capitals as END_SHIFT + letter combos (J is the one QMK can apply at once), the glyphs as LEFT_TOGGLE + letter combos,
+and now and then a tap of HOME_LCTL or END_SHIFT (^ and $ below): a glyph the text follows with a tap is typed as fast
+as the keys allow, so the tap fires while the glyph could still be queued.
+Before some lowercase words END_SHIFT is double tapped, the second press within DOUBLE_TAP_WINDOW_MIN of the first release,
+and caps word types the word in capitals. Some glyphs are typed with END_SHIFT or ESC_ALT held, so a key override replaces them.
+The keyboard reports are decoded back into text, the unicode input sequences of the --unicode mode too (linux by default),
+and the run fails if it differs from what was typed, or if key_override_index_firing() named another override than the one a press activated.
+--trace replays the key edges of a file of ./telemetry_reader.py --trace instead, the combo lines left out.
+--game types the movement and action keys of the first game layer instead, the layer toggled on at boot,
+with the game profile on or off, and prints how long each press and release took from the switch to the report.
+--glyphs types every glyph of keymap.c in every unicode input mode, from the queue and with register_unicode(),
+and fails unless the reports are the same and the hex digits of linux, macos and wincompose decode to the codepoint.
+
+Copyright 2025 Elil50 <@Elil50>
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "game_profile.h"
+#include "unicode_queue.h"
+
+#define COMBO_ROW 254 // the row of a combo event in a replay file
+
+static const char text[] =
+    "The quick brown fox jumps over the lazy dog while Elil types on a split keyboard with a trackpoint "
+    "Combos and key overrides sit between every key and the report the Host gets so each one adds time "
+    "Here the keymap runs on the Computer with the QMK it needs and a clock that moves one scan at a time "
+    "Just the J capital has no longer combo around it "
+    "A glyph such as ∫ or → or ∃ waits in the unicode queue so a tap right after it ∫^must not overtake it "
+    "Shift and Alt held make them ∇ and ∞ or ← and ↔ or ∈ and ∀ through the key overrides ";
+
+// the glyphs of the text: LEFT_TOGGLE held with a letter, END_SHIFT or ESC_ALT held through it for a key override
+static const struct {
+    const char *glyph;
+    uint16_t    letter;
+    uint16_t    mod;
+} glyphs[] = {
+    {"∫", KC_U, KC_NO},                 // MY_INTEGR
+    {"→", KC_V, KC_NO},                 // MY_RIGHTARR
+    {"∃", KC_I, KC_NO},                 // MY_EXIST
+    {"∇", KC_U, MT(MOD_LSFT, KC_END)},  // my_overrides_33
+    {"∞", KC_U, MT(MOD_LALT, KC_ESC)},  // my_overrides_34
+    {"←", KC_V, MT(MOD_LSFT, KC_END)},  // my_overrides_30
+    {"↔", KC_V, MT(MOD_LALT, KC_ESC)},  // my_overrides_31
+    {"∈", KC_I, MT(MOD_LSFT, KC_END)},  // my_overrides_32
+    {"∀", KC_I, MT(MOD_LALT, KC_ESC)},  // my_overrides_5
+};
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t  row;
+    uint8_t  col;
+    bool     closed;
+} edge_t;
+
+static edge_t *edges = NULL;
+static size_t  edge_count = 0;
+static size_t  edge_size = 0;
+
+static char   typed[1 << 16]; // what the reports typed, in UTF-8
+static size_t typed_len = 0;
+
+// --game: the keys of the first game layer, WASD the most
+static const uint16_t game_keys[] = {KC_W, KC_A, KC_S, KC_D, KC_W, KC_A, KC_S, KC_D, KC_E, KC_R, KC_C, KC_V, KC_Z, KC_H, KC_N, KC_SPC};
+
+static uint8_t  game_layer = 0;       // 0: not a game run
+static uint64_t game_edge_us[2][256]; // presses, releases: when the switch of each key last moved, 0 once a report has it
+static uint64_t game_total_us[2];
+static uint64_t game_max_us[2];
+static uint32_t game_count[2];
+
+static const struct {
+    const char *name;
+    uint8_t     mode;
+} unicode_modes[] = {
+    {"linux", UNICODE_MODE_LINUX},
+    {"macos", UNICODE_MODE_MACOS},
+    {"wincompose", UNICODE_MODE_WINCOMPOSE},
+};
+
+static uint32_t rng_state = 1;
+static uint32_t double_taps = 0; // of END_SHIFT, in the built-in text
+static double   key_up[MATRIX_ROWS][MATRIX_COLS]; // ms: when each key was last released
+
+static uint32_t rng(void) { // xorshift32: the same run for the same seed on any libc
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t uniform(uint32_t min, uint32_t max) {
+    return min + rng() % (max - min + 1);
+}
+
+static void add_edge(uint64_t time_us, keypos_t key, bool closed) {
+    if (edge_count == edge_size) {
+        edge_size = edge_size ? edge_size * 2 : 1024;
+        edges     = realloc(edges, edge_size * sizeof(edge_t));
+    }
+    edges[edge_count++] = (edge_t){time_us, key.row, key.col, closed};
+}
+
+static int compare_edges(const void *a, const void *b) {
+    const edge_t *x = a, *y = b;
+    return x->time_us < y->time_us ? -1 : x->time_us > y->time_us;
+}
+
+static bool find_key(uint8_t layer, uint16_t keycode, keypos_t *key) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (keycode_at_keymap_location(layer, row, col) == keycode) {
+                *key = MAKE_KEYPOS(row, col);
+                return true;
+            }
+        }
+    }
+    fprintf(stderr, "replay: keycode 0x%04X is not on layer %u\n", keycode, layer);
+    exit(2);
+}
+
+// a key of the text, in ms: press it after the gap and hold it, returns when it goes up
+static double press(double now, keypos_t key, double hold) {
+    key_up[key.row][key.col] = now + hold;
+    add_edge(now * 1000, key, true);
+    add_edge((now + hold) * 1000, key, false);
+    return now + hold;
+}
+
+// the glyph the text has at next, NULL for an ASCII character
+static const char *find_glyph(const char *next, uint16_t *letter, uint16_t *mod) {
+    for (size_t i = 0; i < sizeof(glyphs) / sizeof(glyphs[0]); i++) {
+        if (!strncmp(next, glyphs[i].glyph, strlen(glyphs[i].glyph))) {
+            *letter = glyphs[i].letter;
+            *mod    = glyphs[i].mod;
+            return glyphs[i].glyph;
+        }
+    }
+    return NULL;
+}
+
+// next starts a word of lowercase letters that a space ends: caps word capitalizes all of it
+static bool lowercase_word(const char *next) {
+    if (next > text && next[-1] != ' ') return false;
+    const char *end = next;
+    while (*end >= 'a' && *end <= 'z') end++;
+    return end > next && *end == ' ';
+}
+
+// the edges of the built-in text, and the text they must type
+static void generate(uint32_t presses, char *expected) {
+    keypos_t end_shift, home_lctl, left_toggle, space;
+    find_key(0, MT(MOD_LSFT, KC_END), &end_shift);
+    find_key(0, MT(MOD_LCTL, KC_HOME), &home_lctl);
+    find_key(0, LT(1, KC_Q), &left_toggle);
+    find_key(0, KC_SPC, &space);
+
+    double      now = 500, released = 0, alone = 0; // ms: now, every key typed so far up, the last chord or tap up
+    double      tapped = -1000; // ms: the last tap went down, a press of the key within its quick tap term is a second tap
+    size_t      len  = 0;
+    bool        tap   = false; // the last character was a Home or End tap
+    bool        caps  = false; // caps word is on until the next space
+    uint8_t     quick = 0;     // characters left to type as fast as the chords and taps allow
+    const char *next  = text;
+    for (uint32_t i = 0; i < presses; i++) {
+        if (!*next) next = text;
+        uint16_t    letter = KC_NO, mod = KC_NO;
+        const char *glyph = find_glyph(next, &letter, &mod);
+        char        c     = glyph ? '*' : *next;
+        double      gap   = uniform(40, 200);
+        double      hold  = uniform(30, 150);
+
+        if (!tap && !quick && !caps && lowercase_word(next) && rng() % 12 == 0) { // a double tap of End: caps word
+            now += gap;
+            if (now < released + 20) now = released + 20;
+            if (now < tapped + 200) now = tapped + 200;
+            double up = press(now, end_shift, uniform(20, 30));
+            up = press(up + uniform(15, 35), end_shift, uniform(20, 30)); // within the shortest window the gaps can teach
+            if (up > released) released = up;
+            tapped    = now;
+            alone     = up;
+            tap       = true;
+            caps      = true;
+            double_taps++;
+            continue;
+        }
+        if (!tap && !quick && !caps && c != '^' && c != '$' && rng() % 40 == 0) { // a Home or End tap, never two in a row: that is a double tap
+            c     = rng() % 2 ? '^' : '$';
+            glyph = NULL;
+        } else {
+            next += glyph ? strlen(glyph) : 1;
+            if (glyph && (*next == '^' || *next == '$')) quick = 3; // the glyph, the tap and the letter: the tap must not overtake the glyph
+        }
+        if (quick) {
+            quick--;
+            gap  = 0;
+            hold = 30;
+        }
+        now += gap;
+
+        bool chord = glyph || (c >= 'A' && c <= 'Z');
+        if (c == '^' || c == '$' || chord) {
+            // alone on the keyboard: a held key would make a tap a combo or a hold, and break a chord
+            if (now < released + 20) now = released + 20;
+            if (now < tapped + 200) now = tapped + 200; // past the tapping term: a tap and a hold, not two taps
+        } else if (now < alone + 20) {
+            now = alone + 20;
+        }
+
+        keypos_t key = space;
+        if (c == '^' || c == '$') key = c == '^' ? home_lctl : end_shift;
+        if (c >= 'A' && c <= 'Z') find_key(0, KC_A + c - 'A', &key);
+        if (c >= 'a' && c <= 'z') find_key(0, KC_A + c - 'a', &key);
+        if (glyph) find_key(0, letter, &key);
+        if (now < key_up[key.row][key.col] + 20) now = key_up[key.row][key.col] + 20; // a held switch gives no second press
+
+        double up;
+        if (c == '^' || c == '$') {
+            up     = press(now, key, gap ? uniform(30, 80) : 30); // within the shortest tapping term
+            alone  = up;
+            tapped = now;
+        } else if (chord) {
+            // END_SHIFT or LEFT_TOGGLE first, the letter within the combo term, both held
+            keypos_t first = glyph ? left_toggle : end_shift;
+            keypos_t held;
+            if (glyph && mod != KC_NO) { // the mod-tap held past its tapping term first: the override sees its mod
+                find_key(0, mod, &held);
+                add_edge(now * 1000, held, true);
+                now += 250;
+            }
+            add_edge(now * 1000, first, true);
+            up = press(now + uniform(5, 30), key, hold) + 15;
+            add_edge(up * 1000, first, false);
+            key_up[first.row][first.col] = up;
+            if (glyph && mod != KC_NO) {
+                up += 15;
+                add_edge(up * 1000, held, false);
+                key_up[held.row][held.col] = up;
+            }
+            alone = up;
+        } else {
+            up = press(now, key, hold);
+        }
+        if (up > released) released = up;
+        if (glyph) {
+            len += sprintf(expected + len, "%s", glyph);
+        } else {
+            expected[len++] = caps && c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
+        }
+        if (c == ' ') caps = false;
+        tap = c == '^' || c == '$';
+    }
+    expected[len] = '\0';
+    qsort(edges, edge_count, sizeof(edge_t), compare_edges);
+}
+
+// the edges of --game: single keys rolling into each other, held longer than letters, and the text they type
+static void generate_game(uint32_t presses, char *expected) {
+    double now = 500;
+    for (uint32_t i = 0; i < presses; i++) {
+        uint16_t keycode = game_keys[rng() % (sizeof(game_keys) / sizeof(game_keys[0]))];
+        keypos_t key;
+        find_key(game_layer, keycode, &key);
+        now += uniform(40, 200);
+        if (now < key_up[key.row][key.col] + 20) now = key_up[key.row][key.col] + 20;
+        press(now, key, uniform(30, 300));
+        expected[i] = keycode == KC_SPC ? ' ' : 'a' + keycode - KC_A;
+    }
+    expected[presses] = '\0';
+    qsort(edges, edge_count, sizeof(edge_t), compare_edges);
+}
+
+// --game: a key that came into the report or left it, against the switch edge that moved it
+static void game_report(const report_keyboard_t *report) {
+    static report_keyboard_t last;
+    for (uint16_t code = KC_A; code <= KC_SPC; code++) {
+        bool    now     = memchr(report->keys, code, sizeof(report->keys));
+        bool    was     = memchr(last.keys, code, sizeof(last.keys));
+        uint8_t release = !now;
+        if (now == was || !game_edge_us[release][code]) continue;
+
+        uint64_t elapsed = host_now_us() - game_edge_us[release][code];
+        game_total_us[release] += elapsed;
+        if (elapsed > game_max_us[release]) game_max_us[release] = elapsed;
+        game_count[release]++;
+        game_edge_us[release][code] = 0;
+    }
+    last = *report;
+}
+
+static bool load_trace(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned time_ms, row, col;
+        char     direction;
+        if (line[0] == '#' || sscanf(line, "%u %u %u %c", &time_ms, &row, &col, &direction) != 4) continue;
+        if (row == COMBO_ROW || row >= MATRIX_ROWS || col >= MATRIX_COLS) continue; // a combo is no switch
+        add_edge((500 + (uint64_t)time_ms) * 1000, MAKE_KEYPOS(row, col), direction == 'd');
+    }
+    fclose(file);
+    return true;
+}
+
+static int8_t hex_digit(uint8_t code) {
+    if (code == KC_0) return 0;
+    if (code >= KC_1 && code <= KC_9) return 1 + code - KC_1;
+    if (code >= KC_A && code <= KC_F) return 10 + code - KC_A;
+    return -1;
+}
+
+// the UTF-8 bytes of a BMP codepoint, returns how many
+static size_t utf8(uint32_t code, char *out) {
+    if (code < 0x80) {
+        out[0] = code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = 0xC0 | code >> 6;
+        out[1] = 0x80 | (code & 0x3F);
+        return 2;
+    }
+    out[0] = 0xE0 | code >> 12;
+    out[1] = 0x80 | (code >> 6 & 0x3F);
+    out[2] = 0x80 | (code & 0x3F);
+    return 3;
+}
+
+static void type_codepoint(uint32_t code) {
+    typed_len += utf8(code, typed + typed_len);
+}
+
+// a new key in the report is a character, with the shift of the same report,
+// or a part of the unicode input of the host, the hex digits between:
+// linux: Ctrl+Shift+U and Space, macos: a press and a release of Left Alt, wincompose: a tap of Right Alt, U and Enter
+static void decode_report(const report_keyboard_t *report) {
+    static report_keyboard_t last;
+    static bool              compose   = false; // wincompose: Right Alt tapped, U comes next
+    static bool              hex_input = false;
+    static uint8_t           hex_digits;
+    static uint32_t          hex_code;
+    bool                     shift = report->mods & MOD_MASK_SHIFT;
+    uint8_t                  mode  = get_unicode_input_mode();
+    uint8_t                  down  = report->mods & ~last.mods;
+    bool                     empty = true; // mods only: how the unicode inputs start
+
+    if (game_layer) game_report(report);
+    for (uint8_t i = 0; i < sizeof(report->keys); i++) {
+        if (report->keys[i] != KC_NO) empty = false;
+    }
+
+    if (mode == UNICODE_MODE_MACOS) {
+        if (hex_input && !(report->mods & MOD_BIT(KC_LEFT_ALT))) {
+            hex_input = false;
+            if (hex_digits) type_codepoint(hex_code);
+        }
+        if ((down & MOD_BIT(KC_LEFT_ALT)) && empty) {
+            hex_input  = true;
+            hex_digits = 0;
+            hex_code   = 0;
+        }
+    }
+    if (mode == UNICODE_MODE_WINCOMPOSE && (down & MOD_BIT(KC_RIGHT_ALT)) && empty) compose = true;
+
+    for (uint8_t i = 0; i < sizeof(report->keys); i++) {
+        uint8_t code = report->keys[i];
+        if (code == KC_NO || memchr(last.keys, code, sizeof(last.keys)) || typed_len >= sizeof(typed) - 4) continue;
+
+        if (compose) {
+            compose   = false;
+            hex_input = code == KC_U;
+            if (hex_input) {
+                hex_digits = 0;
+                hex_code   = 0;
+                continue;
+            }
+        }
+        if (hex_input) {
+            if (hex_digit(code) >= 0) {
+                hex_code = hex_code << 4 | hex_digit(code);
+                hex_digits++;
+                continue;
+            }
+            hex_input = false;
+            if ((mode == UNICODE_MODE_LINUX && code == KC_SPC) || (mode == UNICODE_MODE_WINCOMPOSE && code == KC_ENTER)) {
+                type_codepoint(hex_code);
+                continue;
+            }
+        }
+        if (mode == UNICODE_MODE_LINUX && code == KC_U && shift && (report->mods & MOD_MASK_CTRL)) {
+            hex_input  = true;
+            hex_digits = 0;
+            hex_code   = 0;
+            continue;
+        }
+
+        char c = '?';
+        if (code >= KC_A && code <= KC_Z) c = (shift ? 'A' : 'a') + code - KC_A;
+        if (code == KC_SPC) c = ' ';
+        if (code == KC_HOME) c = '^';
+        if (code == KC_END) c = '$';
+        typed[typed_len++] = c;
+    }
+    last = *report;
+}
+
+// --glyphs: the reports of one glyph from register_unicode(), then from the queue
+#define GLYPH_REPORTS 64
+
+static report_keyboard_t glyph_reports[2][GLYPH_REPORTS];
+static uint8_t           glyph_report_count[2];
+static uint8_t           glyph_run;
+
+static void record_glyph_report(const report_keyboard_t *report) {
+    if (glyph_report_count[glyph_run] < GLYPH_REPORTS) glyph_reports[glyph_run][glyph_report_count[glyph_run]++] = *report;
+    decode_report(report);
+}
+
+static bool check_glyphs(void) {
+    static const struct {
+        const char *name;
+        uint8_t     mode;
+        bool        decoded; // decode_report reads its hex input
+    } modes[] = {
+        {"linux", UNICODE_MODE_LINUX, true},      {"macos", UNICODE_MODE_MACOS, true}, {"wincompose", UNICODE_MODE_WINCOMPOSE, true},
+        {"windows", UNICODE_MODE_WINDOWS, false}, {"bsd", UNICODE_MODE_BSD, false},    {"emacs", UNICODE_MODE_EMACS, false},
+    };
+    bool ok = true;
+
+    host_set_report_hook(record_glyph_report);
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        set_unicode_input_mode(modes[i].mode);
+        uint8_t  name;
+        uint32_t reports = 0;
+        for (name = 0; host_glyph_codepoint(name); name++) {
+            uint16_t code = host_glyph_codepoint(name);
+            char     expected[8];
+            size_t   len = utf8(code, expected);
+
+            memset(glyph_report_count, 0, sizeof(glyph_report_count));
+            typed_len = 0;
+            glyph_run = 0;
+            register_unicode(code);
+            glyph_run = 1;
+            unicode_queue_push(name);
+            unicode_queue_flush();
+            reports += glyph_report_count[1];
+
+            if (glyph_report_count[0] != glyph_report_count[1] ||
+                memcmp(glyph_reports[0], glyph_reports[1], glyph_report_count[0] * sizeof(report_keyboard_t))) {
+                printf("glyphs %s: U+%04X is typed in %u reports, unlike the %u of register_unicode()\n", modes[i].name, code,
+                       glyph_report_count[1], glyph_report_count[0]);
+                ok = false;
+            } else if (modes[i].decoded && (typed_len != 2 * len || memcmp(typed, expected, len) || memcmp(typed + len, expected, len))) {
+                printf("glyphs %s: U+%04X decodes as %.*s\n", modes[i].name, code, (int)typed_len, typed);
+                ok = false;
+            }
+        }
+        printf("glyphs %-10s %u glyphs in %u reports, as register_unicode() types them%s\n", modes[i].name, name, reports,
+               modes[i].decoded ? ", decoded to their codepoints" : "");
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    uint32_t    presses = 2000;
+    const char *unicode = NULL;
+    const char *trace   = NULL;
+    const char *game    = NULL;
+    bool        glyphs  = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--presses") && i + 1 < argc) {
+            presses = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            rng_state = strtoul(argv[++i], NULL, 0) | 1;
+        } else if (!strcmp(argv[i], "--scan-us") && i + 1 < argc) {
+            host_set_scan_us(strtoul(argv[++i], NULL, 0));
+        } else if (!strcmp(argv[i], "--unicode") && i + 1 < argc) {
+            unicode = argv[++i];
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            trace = argv[++i];
+        } else if (!strcmp(argv[i], "--game") && i + 1 < argc && (!strcmp(argv[i + 1], "on") || !strcmp(argv[i + 1], "off"))) {
+            game = argv[++i];
+        } else if (!strcmp(argv[i], "--glyphs")) {
+            glyphs = true;
+        } else {
+            fprintf(stderr, "usage: %s [--presses N] [--seed N] [--scan-us us] [--unicode linux|macos|wincompose] [--trace FILE] [--game on|off] [--glyphs]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (presses >= sizeof(typed) / 4) presses = sizeof(typed) / 4 - 1; // up to 3 bytes a character
+
+    static char expected[sizeof(typed)];
+    host_init();
+    if (glyphs) return check_glyphs() ? 0 : 1;
+    host_set_report_hook(decode_report);
+    for (size_t i = 0; unicode && i < sizeof(unicode_modes) / sizeof(unicode_modes[0]); i++) {
+        if (!strcmp(unicode, unicode_modes[i].name)) {
+            set_unicode_input_mode(unicode_modes[i].mode); // as the mode key would, over the detected OS
+            unicode = NULL;
+        }
+    }
+    if (unicode) {
+        fprintf(stderr, "replay: unknown unicode mode %s\n", unicode);
+        return 2;
+    }
+    if (game) {
+        game_layer = host_game_layer();
+        if (!strcmp(game, "off")) game_profile_init(MAX_LAYER); // no layer is a game: combos, overrides and debounce as in typing
+        layer_on(game_layer); // as its TG on layer 2
+        generate_game(presses, expected);
+    } else if (trace) {
+        if (!load_trace(trace)) return 2;
+    } else {
+        generate(presses, expected);
+    }
+
+    for (size_t i = 0; i < edge_count; i++) {
+        host_run_until(edges[i].time_us);
+        host_key(edges[i].row, edges[i].col, edges[i].closed);
+        if (game_layer) game_edge_us[!edges[i].closed][keycode_at_keymap_location(game_layer, edges[i].row, edges[i].col) & 0xFF] = edges[i].time_us;
+    }
+    host_run_until(host_now_us() + 1000000); // every pending tap, combo and burst expires
+    typed[typed_len] = '\0';
+
+    host_keymap_dump();
+    printf("host: %zu edges in %llu ms, keyboard reports=%u mouse reports=%u extra reports=%u\n", edge_count,
+           (unsigned long long)host_now_us() / 1000, host_keyboard_reports(), host_mouse_reports(), host_extra_reports());
+    printf("host: longest pointing device task of the trackpoint init %lu us\n", (unsigned long)host_ps2_task_max_us());
+    if (game_layer) {
+        printf("game: profile %s presses=%u avg=%llu max=%llu us, releases=%u avg=%llu max=%llu us\n", game, game_count[0],
+               (unsigned long long)(game_count[0] ? game_total_us[0] / game_count[0] : 0), (unsigned long long)game_max_us[0], game_count[1],
+               (unsigned long long)(game_count[1] ? game_total_us[1] / game_count[1] : 0), (unsigned long long)game_max_us[1]);
+    }
+    if (trace) return 0;
+
+    size_t same = 0;
+    while (expected[same] && expected[same] == typed[same]) same++;
+    if (expected[same] || typed[same]) {
+        printf("host: typed text differs after %zu characters\n  expected: %.60s\n  typed:    %.60s\n", same, expected + same, typed + same);
+        return 1;
+    }
+    if (host_overrides_mispredicted()) {
+        printf("host: key_override_index_firing() mispredicted %u of the presses, %u overrides fired\n", host_overrides_mispredicted(),
+               host_overrides_fired());
+        return 1;
+    }
+    printf("host: typed %zu characters as expected, %u words in caps word, %u key overrides as key_override_index_firing() told\n",
+           typed_len, double_taps, host_overrides_fired());
+    return 0;
+}
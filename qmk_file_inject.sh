@@ -1,12 +1,14 @@
 KEYMAP="./Elil_50/keymap.c"
 CONFIG="./Elil_50/config.h"
 RULES="./Elil_50/rules.mk"
+MODULES="./Elil_50/*.[ch]" # keymap.c, config.h and the user modules listed in rules.mk
 TARGET="./qmk_firmware/keyboards/crkbd/keymaps"
 PS2="./PS2_patches"
 
 mkdir -p "$TARGET/Elil_50"
 cp "$KEYMAP" "$TARGET/Elil_50"
 cp "$CONFIG" "$TARGET/Elil_50"
+cp $MODULES "$TARGET/Elil_50"
 cp "$RULES" "$TARGET/Elil_50"
 
 mkdir -p ./qmk_firmware/PS2_patches
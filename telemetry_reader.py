@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+# Reads the raw HID telemetry of Elil_50/telemetry.c (build with MY_TELEMETRY_ENABLE = yes)
+# usage: ./telemetry_reader.py [--interval ms] [--device /dev/hidrawN] [--loopback]
+# --loopback runs against a fake keyboard in this process, to check the decoding without the board
+#
+# The key trace of Elil_50/key_trace.c (MY_TRACE_ENABLE) is saved as a replay file with
+#   ./telemetry_reader.py --trace typing.trace                  (raw HID, needs MY_TELEMETRY_ENABLE too)
+#   ./telemetry_reader.py --trace typing.trace --console log    (from "qmk console > log" and shift + LAT_DUMP)
+# Replay file: one event per line, "time_ms row col d|u keycode resolution delay_ms",
+# time from the first event, resolution one of RESOLUTIONS; read it back with load_trace()
+
+import argparse
+import glob
+import os
+import struct
+import sys
+import time
+
+MAGIC = 0xE7
+VERSION = 3
+START, STOP, TRACE = 1, 0, 2
+COUNTERS, PHASES, TRACE_EVENTS = 1, 2, 3
+FRAME = 32  # RAW_EPSIZE
+
+HEADER = struct.Struct("<BBBBH")  # telemetry_header_t
+COUNTER_FIELDS = ("scans", "key_presses", "combo_hits", "override_hits", "keyboard_reports", "mouse_reports",
+                  "ps2_packets", "ps2_errors", "ps2_resyncs", "ps2_recoveries")
+COUNTER_BODY = struct.Struct("<%dH" % (len(COUNTER_FIELDS) + 3))
+PHASE_NAMES = ("matrix", "debounce", "action", "resolve", "combo", "override", "user", "pointing", "usb", "other", "loop")  # enum scan_profile_phase
+PHASE_BODY = struct.Struct("<%dH" % (len(PHASE_NAMES) + 1))
+
+TRACE_EVENT = struct.Struct("<HBBHBB")  # key_trace_event_t
+TRACE_COUNT = struct.Struct("<BB")  # events in the frame, reserved
+COMBO_ROW = 0xFE
+RESOLUTIONS = ("pending", "plain", "tap", "hold", "combo")  # enum key_trace_resolution
+
+# the usage page 0xFF60 and usage 0x61 of the QMK raw HID interface, as they appear in the report descriptor
+RAW_USAGE = bytes((0x06, 0x60, 0xFF, 0x09, 0x61))
+
+
+def find_device(vid_pid=None):
+    for node in sorted(glob.glob("/sys/class/hidraw/hidraw*")):
+        try:
+            with open(os.path.join(node, "device/report_descriptor"), "rb") as f:
+                if RAW_USAGE not in f.read():
+                    continue
+            with open(os.path.join(node, "device/uevent")) as f:
+                uevent = f.read()
+        except OSError:
+            continue
+        if vid_pid:
+            vid, pid = (int(x, 16) for x in vid_pid.split(":"))
+            if "HID_ID=0003:%08X:%08X" % (vid, pid) not in uevent:
+                continue
+        return "/dev/" + os.path.basename(node)
+    return None
+
+
+def command(code, interval):
+    # report id 0, then the 32 bytes of the frame
+    return bytes((0, MAGIC, code)) + struct.pack("<H", interval) + bytes(FRAME - 4)
+
+
+def decode(frame):
+    magic, version, kind, sequence, interval = HEADER.unpack_from(frame)
+    if magic != MAGIC or version != VERSION:
+        return None
+    if kind == COUNTERS:
+        values = COUNTER_BODY.unpack_from(frame, HEADER.size)
+        return kind, sequence, interval, dict(zip(COUNTER_FIELDS, values))
+    if kind == TRACE_EVENTS:
+        count = TRACE_COUNT.unpack_from(frame, HEADER.size)[0]
+        offset = HEADER.size + TRACE_COUNT.size
+        events = [TRACE_EVENT.unpack_from(frame, offset + i * TRACE_EVENT.size) for i in range(count)]
+        return kind, sequence, interval, events
+    if kind == PHASES:
+        values = PHASE_BODY.unpack_from(frame, HEADER.size)
+        phases = dict(zip(PHASE_NAMES, values))
+        phases["loop_max"] = values[len(PHASE_NAMES)]
+        return kind, sequence, interval, phases
+    return None
+
+
+def show(kind, sequence, interval, values):
+    seconds = interval / 1000 or 1
+    if kind == COUNTERS:
+        rates = " ".join("%s=%.0f/s" % (name, values[name] / seconds) for name in COUNTER_FIELDS if values[name] or name == "scans")
+        print("#%03d %5d ms %s" % (sequence, interval, rates))
+    else:
+        us = " ".join("%s=%d" % (name, values[name]) for name in PHASE_NAMES if values[name])
+        print("#%03d %5d ms us per loop: %s max_loop=%d" % (sequence, interval, us, values["loop_max"]))
+    sys.stdout.flush()
+
+
+def trace_line(time_ms, row, col, pressed, keycode, resolution, delay):
+    return "%d %d %d %s 0x%04X %s %d" % (time_ms, row, col, "d" if pressed else "u", keycode, RESOLUTIONS[resolution], delay)
+
+
+def write_trace(path, events):
+    # events: (time, row, col, flags, keycode, delay) with the 16 bit time of the keyboard, oldest first
+    with open(path, "w") as f:
+        f.write("# key trace v1: time_ms row col d|u keycode resolution delay_ms\n")
+        last, unwrapped = None, 0
+        for time16, row, col, flags, keycode, delay in events:
+            unwrapped += 0 if last is None else (time16 - last) & 0xFFFF  # gaps over 65 s come out shorter
+            last = time16
+            f.write(trace_line(unwrapped, row, col, flags & 0x80, keycode, flags & 0x07, delay) + "\n")
+    print("%d events written to %s" % (len(events), path))
+
+
+def load_trace(path):
+    # the replay file as a list of dicts, for the host harness
+    events = []
+    with open(path) as f:
+        for line in f:
+            if line.startswith("#") or not line.strip():
+                continue
+            time_ms, row, col, direction, keycode, resolution, delay = line.split()
+            events.append({"time": int(time_ms), "row": int(row), "col": int(col), "pressed": direction == "d",
+                           "keycode": int(keycode, 16), "resolution": resolution, "delay": int(delay),
+                           "combo": int(row) == COMBO_ROW})
+    return events
+
+
+def trace_from_console(log):
+    # the last dump in the log: "kt v1 N events", then "kt time row col d|u keycode resolution delay"
+    events = None
+    with open(log, errors="replace") as f:
+        for line in f:
+            fields = line.split()
+            if "kt" not in fields:
+                continue
+            fields = fields[fields.index("kt") + 1:]
+            if fields[:1] == ["v1"]:
+                events = []
+            elif events is not None and len(fields) == 7:
+                time16, row, col, direction, keycode, resolution, delay = fields
+                flags = (0x80 if direction == "d" else 0) | int(resolution)
+                events.append((int(time16), int(row), int(col), flags, int(keycode, 16), int(delay)))
+    if events is None:
+        sys.exit("no key trace dump in %s, tap shift + LAT_DUMP with qmk console running" % log)
+    return events
+
+
+def read_trace(commands, frames):
+    os.write(commands, command(TRACE, 0))
+    events, deadline = [], time.monotonic() + 5
+    while time.monotonic() < deadline:
+        try:
+            frame = os.read(frames, FRAME)
+        except BlockingIOError:
+            time.sleep(0.01)
+            continue
+        decoded = decode(frame) if len(frame) == FRAME else None
+        if not decoded or decoded[0] != TRACE_EVENTS:
+            continue  # windows of a reader still streaming
+        if not decoded[3]:
+            return events
+        for time16, row, col, keycode, flags, delay in decoded[3]:
+            events.append((time16, row, col, flags, keycode, delay))
+    sys.exit("the trace did not end, is MY_TRACE_ENABLE set?")
+
+
+def fake_keyboard(commands, frames):
+    # encodes frames the way telemetry.c does, from made up counts
+    streaming, interval, sequence, window_start = False, 1000, 0, 0
+    while True:
+        data = os.read(commands, FRAME + 1)
+        if not data:
+            return
+        data = data[1:]
+        if data[0] == MAGIC and data[1] == START:
+            interval = max(struct.unpack_from("<H", data, 2)[0], 100)
+            if not streaming:
+                streaming, window_start = True, time.monotonic()
+        elif data[0] == MAGIC and data[1] == STOP:
+            streaming = False
+        elif data[0] == MAGIC and data[1] == TRACE:
+            # a press and release of "a" and a tapped mod-tap across the wrap of the 16 bit clock
+            trace = [(65500, 1, 1, 0x0004, 0x81, 0), (65530, 1, 1, 0x0004, 0x01, 0),
+                     (10, 3, 5, 0x2228, 0x82, 96), (90, 3, 5, 0x2228, 0x02, 0)]
+            for i in range(0, len(trace) + 3, 3):  # the last frame is empty
+                events = trace[i:i + 3]
+                body = TRACE_COUNT.pack(len(events), 0) + b"".join(TRACE_EVENT.pack(*e) for e in events)
+                os.write(frames, HEADER.pack(MAGIC, VERSION, TRACE_EVENTS, i // 3, len(trace)) + body.ljust(FRAME - HEADER.size, b"\0"))
+        while streaming and time.monotonic() - window_start >= interval / 1000:
+            length = int((time.monotonic() - window_start) * 1000)
+            window_start = time.monotonic()
+            counts = (3000 * length // 1000, 7, 1, 2, 16, 40, 40, 0, 0, 0, 0, 0, 0)
+            os.write(frames, HEADER.pack(MAGIC, VERSION, COUNTERS, sequence, length) + COUNTER_BODY.pack(*counts))
+            phases = (110, 10, 4, 2, 1, 3, 1, 60, 20, 40, 250, 900) + (0,) * 1
+            os.write(frames, HEADER.pack(MAGIC, VERSION, PHASES, sequence, length) + struct.pack("<13H", *phases))
+            sequence = (sequence + 1) & 0xFF
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read the raw HID telemetry of the keyboard")
+    parser.add_argument("--interval", type=int, default=1000, help="window length in ms (default 1000)")
+    parser.add_argument("--device", help="hidraw node, found from the report descriptor if omitted")
+    parser.add_argument("--vid-pid", help="VID:PID in hex, to pick one of several QMK boards")
+    parser.add_argument("--loopback", action="store_true", help="read from a fake keyboard instead")
+    parser.add_argument("--count", type=int, default=0, help="stop after this many windows")
+    parser.add_argument("--trace", metavar="FILE", help="save the key trace as a replay file instead of streaming")
+    parser.add_argument("--console", metavar="LOG", help="with --trace, take the trace from a qmk console log")
+    args = parser.parse_args()
+
+    if args.console:
+        if not args.trace:
+            sys.exit("--console needs --trace FILE")
+        write_trace(args.trace, trace_from_console(args.console))
+        return
+
+    if args.loopback:
+        to_fake, commands = os.pipe()
+        frames, from_fake = os.pipe()
+        if os.fork() == 0:
+            os.close(commands)
+            os.close(frames)
+            fake_keyboard(to_fake, from_fake)
+            os._exit(0)
+        os.close(to_fake)
+        os.close(from_fake)
+        # the fake only answers when it is written to, so renew the lease faster than the windows
+        renew = min(args.interval, 1000) / 2000
+    else:
+        device = args.device or find_device(args.vid_pid)
+        if not device:
+            sys.exit("no raw HID device found, is MY_TELEMETRY_ENABLE set?")
+        commands = frames = os.open(device, os.O_RDWR)
+        renew = 1.0
+        print("reading %s" % device)
+
+    os.set_blocking(frames, False)
+    if args.trace:
+        write_trace(args.trace, read_trace(commands, frames))
+        return
+    last_renew = 0
+    windows = 0
+    expected = None
+    try:
+        while not args.count or windows < args.count:
+            if time.monotonic() - last_renew >= renew:
+                os.write(commands, command(START, args.interval))
+                last_renew = time.monotonic()
+            try:
+                frame = os.read(frames, FRAME)
+            except BlockingIOError:
+                time.sleep(0.01)
+                continue
+            decoded = decode(frame) if len(frame) == FRAME else None
+            if not decoded:
+                continue  # another user of the raw HID interface, e.g. VIA
+            kind, sequence = decoded[0], decoded[1]
+            if kind == COUNTERS:
+                if expected is not None and sequence != expected:
+                    print("lost %d windows" % ((sequence - expected) & 0xFF))
+                expected = (sequence + 1) & 0xFF
+                windows += 1
+            show(*decoded)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.write(commands, command(STOP, 0))
+
+
+if __name__ == "__main__":
+    main()